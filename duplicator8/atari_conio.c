@@ -5,13 +5,20 @@
 
 #include "atari_conio.h"
 
+// Screen buffer the drawing functions write to
+static byte* draw_screen = SCREEN_MEM;
+
 void my_clrscr(void) {
-    memset(SCREEN_MEM, 0, COLS * ROWS);
+    memset(draw_screen, 0, COLS * ROWS);
+}
+
+void my_set_draw_screen(byte* screen) {
+    draw_screen = screen;
 }
 
 void my_cputcxy(byte x, byte y, byte character) {
     word offset = (word)y * COLS + x;
-    SCREEN_MEM[offset] = character;
+    draw_screen[offset] = character;
 }
 
 void my_cputsxy(byte x, byte y, const char* str) {
@@ -20,9 +27,9 @@ void my_cputsxy(byte x, byte y, const char* str) {
         byte v = *str++;
         // Convert ASCII to ATASCII (internal screen codes)
         if (v >= 0x20 && v <= 0x5f) {
-            SCREEN_MEM[offset++] = v - 0x20;
+            draw_screen[offset++] = v - 0x20;
         } else if (v >= 0x60 && v <= 0x7f) {
-            SCREEN_MEM[offset++] = v - 0x60;
+            draw_screen[offset++] = v - 0x60;
         }
     }
 }
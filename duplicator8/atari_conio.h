@@ -22,12 +22,21 @@ typedef unsigned short word;
 
 // Manual Memory Layout
 #define SCREEN_MEM  ((byte*)0x9000)
+#define SCREEN_MEM_2 ((byte*)0x9800)  // Second buffer for off-screen redraws
 
 /*
   Clear the screen by filling screen memory with zeros
 */
 void my_clrscr(void);
 
+/*
+  Select the screen buffer that the drawing functions write to
+  (does not change which buffer is displayed)
+
+  @param screen - SCREEN_MEM or SCREEN_MEM_2
+*/
+void my_set_draw_screen(byte* screen);
+
 /*
   Put a character at specific x,y coordinates
   
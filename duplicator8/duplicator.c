@@ -8,6 +8,9 @@
 /*
   Duplicator Game - Playable Version
   Based on the PuzzleScript game by competor
+
+  Build every source with -DENGINE_UNDO to record an undo timeline and
+  bind U to undo and Y to redo (costs over 1 KB of RAM).
 */
 
 #include "duplicator_font.h"
@@ -500,6 +503,32 @@ void setup_duplicator_graphics(void) {
     POKE(752, 1);
 }
 
+// Screen buffers: the display list shows one while full redraws are
+// built in the other
+static byte* visible_screen = SCREEN_MEM;
+static byte* hidden_screen = SCREEN_MEM_2;
+
+// Point the display list LMS at a screen buffer
+// (call during vblank so the frame being drawn doesn't change buffer)
+static void show_screen(byte* screen) {
+    DLIST_MEM[4] = (byte)(word)screen;
+    DLIST_MEM[5] = (byte)((word)screen >> 8);
+}
+
+// Show the buffer a full redraw was built in and keep drawing
+// per-turn changes into it
+static void swap_screens(void) {
+    byte* screen;
+
+    wait_vblank();
+    show_screen(hidden_screen);
+
+    screen = visible_screen;
+    visible_screen = hidden_screen;
+    hidden_screen = screen;
+    my_set_draw_screen(visible_screen);
+}
+
 // Main function
 void main(void) {
     byte joy, last_joy = 0;
@@ -514,7 +543,9 @@ void main(void) {
     setup_duplicator_graphics();
 
 start_level:
-    // Clear screen
+    // Build the level in the hidden buffer so the old one stays on
+    // screen until the new one is complete
+    my_set_draw_screen(hidden_screen);
     my_clrscr();
 
     // Load and draw current level
@@ -522,6 +553,7 @@ start_level:
     state = get_game_state();
     state->current_level = current_level;
     draw_level();
+    swap_screens();
 
     // Main game loop
     while (1) {
@@ -553,6 +585,12 @@ start_level:
                 try_move_player(-1, 0);
             } else if (key == CH_CURS_RIGHT || key == 'd' || key == 'D') {
                 try_move_player(1, 0);
+#ifdef ENGINE_UNDO
+            } else if (key == 'u' || key == 'U') {
+                undo_turn();
+            } else if (key == 'y' || key == 'Y') {
+                redo_turn();
+#endif
             } else if (key == CH_ESC) {
                 break;  // Exit game
             }
@@ -564,18 +602,16 @@ start_level:
             // Wait a moment to show completion
             for (i = 0; i < 30; i++) {
                 wait_vblank();
+                flush_dirty_cells();
             }
 
             // Check if level was completed successfully (1) or failed (2)
             if (state->level_complete == 2) {
-                // Enemy caught player - restart current level
-                goto start_level;
-            }
-
-            // Level completed successfully
-            // Check if there are more levels
-            if (current_level < NUM_LEVELS - 1) {
-                // Go to next level
+                // Enemy caught player - restart current level (only the
+                // cells that changed are redrawn, below)
+                restart_level();
+            } else if (current_level < NUM_LEVELS - 1) {
+                // Level completed successfully - go to next level
                 current_level++;
                 goto start_level;
             } else {
@@ -585,7 +621,9 @@ start_level:
             }
         }
 
+        // Show this turn's changes while the beam is off screen
         wait_vblank();
+        flush_dirty_cells();
     }
 }
 
@@ -4,167 +4,501 @@
 */
 
 #include "duplicator_game.h"
+#include "duplicator_tile_props.h"  // Generated const tile tables
 #include "atari_conio.h"
 
-// Game state
-static GameState game_state;
-
-// Level data storage
-static char level_map[MAX_LEVEL_HEIGHT][MAX_LEVEL_WIDTH];
-// Background layer (for tiles under objects)
-static char background_map[MAX_LEVEL_HEIGHT][MAX_LEVEL_WIDTH];
-
-// Tile category lookup table (256 bytes - one for each ASCII character)
-// Each byte contains bit flags for tile properties
-byte tile_categories[256];
-
-// Initialize the tile category lookup table
-static void init_tile_categories(void) {
-    // Initialize all to 0 (no flags)
-    memset(tile_categories, 0, sizeof(tile_categories));
-
-    // Set tile categories
-    tile_categories[' '] = TILE_CAT_PASSABLE;                                    // TILE_EMPTY
-    tile_categories['.'] = TILE_CAT_PASSABLE;                                    // TILE_FLOOR
-    tile_categories['#'] = TILE_CAT_BLOCKING;                                    // TILE_WALL
-    tile_categories['p'] = TILE_CAT_BLOCKING;                                    // TILE_PLAYER (blocking to other players)
-    tile_categories['*'] = TILE_CAT_BLOCKING | TILE_CAT_PUSHABLE;                // TILE_CRATE
-    tile_categories['k'] = TILE_CAT_BLOCKING | TILE_CAT_PUSHABLE;                // TILE_KEY
-    tile_categories['e'] = TILE_CAT_BLOCKING | TILE_CAT_PUSHABLE;                // TILE_ENEMY
-    tile_categories['d'] = TILE_CAT_BLOCKING;                                    // TILE_DOOR (closed)
-    tile_categories['D'] = TILE_CAT_PASSABLE;                                    // TILE_DOOR_OPEN
-    tile_categories['?'] = TILE_CAT_PASSABLE | TILE_CAT_HOLE;                    // TILE_HOLE_A
-    tile_categories['!'] = TILE_CAT_PASSABLE | TILE_CAT_HOLE;                    // TILE_HOLE_B
-    tile_categories['['] = TILE_CAT_PASSABLE | TILE_CAT_HOLE;                    // TILE_HOLE_A filled
-    tile_categories[']'] = TILE_CAT_PASSABLE | TILE_CAT_HOLE;                    // TILE_HOLE_B filled
-    tile_categories['b'] = TILE_CAT_PASSABLE | TILE_CAT_PLATE;                   // TILE_PLATE_A
-    tile_categories['c'] = TILE_CAT_PASSABLE | TILE_CAT_PLATE;                   // TILE_PLATE_B
-    tile_categories['g'] = TILE_CAT_BLOCKING | TILE_CAT_GATE;                    // TILE_GATE_A (closed)
-    tile_categories['h'] = TILE_CAT_BLOCKING | TILE_CAT_GATE;                    // TILE_GATE_B (closed)
-    tile_categories['G'] = TILE_CAT_PASSABLE | TILE_CAT_GATE;                    // TILE_GATE_A (open)
-    tile_categories['H'] = TILE_CAT_PASSABLE | TILE_CAT_GATE;                    // TILE_GATE_B (open)
-    tile_categories['@'] = TILE_CAT_PASSABLE | TILE_CAT_EXIT;                    // TILE_EXIT_A
-    tile_categories[':'] = TILE_CAT_PASSABLE | TILE_CAT_EXIT;                    // TILE_EXIT_B
-    tile_categories[';'] = TILE_CAT_PASSABLE | TILE_CAT_EXIT;                    // TILE_EXIT_C
-    tile_categories['$'] = TILE_CAT_BLOCKING;                                    // Wall line A
-    tile_categories['%'] = TILE_CAT_BLOCKING;                                    // Wall line B
-    tile_categories['&'] = TILE_CAT_BLOCKING;                                    // Wall line C
-    tile_categories['1'] = TILE_CAT_PASSABLE;                                    // Decorative line 1
-    tile_categories['2'] = TILE_CAT_PASSABLE;                                    // Decorative line 2
-    tile_categories['3'] = TILE_CAT_PASSABLE;                                    // Decorative line 3
-    tile_categories['4'] = TILE_CAT_PASSABLE;                                    // Decorative line 4
-    tile_categories['5'] = TILE_CAT_PASSABLE;                                    // Decorative line 5
-    tile_categories['6'] = TILE_CAT_PASSABLE;                                    // Decorative line 6
-    tile_categories['7'] = TILE_CAT_PASSABLE;                                    // Decorative line 7
-    tile_categories['8'] = TILE_CAT_PASSABLE;                                    // Decorative line 8
-}
-
-// Simple queue for flood fill (reduced size to save memory)
-typedef struct {
-    byte x;
-    byte y;
-} Position;
+// Engine state lives in an EngineContext (see duplicator_game.h) that
+// every function reaches through 'ctx'. The Atari builds have one static
+// context and ctx is its address, so state is still read with absolute
+// loads and no pointer is passed around. ENGINE_REENTRANT builds pass the
+// context as the first parameter instead; the public functions compile
+// as the engine_* API and the plain names at the end of this file forward
+// to a default context.
+#ifdef ENGINE_REENTRANT
+#define CTX_VOID  EngineContext* ctx
+#define CTX_PARAM EngineContext* ctx,
+#define CTX_ONLY  ctx
+#define CTX_ARG   ctx,
+
+#ifdef ENGINE_LEVEL_STRINGS
+#define load_level                 engine_load_level
+#endif
+#ifdef ENGINE_LEVEL_PACKED
+#define load_packed_level          engine_load_packed_level
+#endif
+#define draw_level                 engine_draw_level
+#define restart_level              engine_restart_level
+#define reset_duplication_tracking engine_reset_duplication_tracking
+#define try_move_player            engine_try_move_player
+#define is_level_complete          engine_is_level_complete
+#define get_game_state             engine_get_game_state
+#define get_tile                   engine_get_tile
+#define get_entity_at              engine_get_entity_at
+#define set_tile                   engine_set_tile
+#define try_push                   engine_try_push
+#define door_flood_fill            engine_door_flood_fill
+#define remove_open_doors          engine_remove_open_doors
+#define handle_key_door            engine_handle_key_door
+#define update_gates               engine_update_gates
+#define handle_duplication         engine_handle_duplication
+#define move_enemies               engine_move_enemies
+#define set_tile_and_draw          engine_set_tile_and_draw
+#define flush_dirty_cells          engine_flush_dirty_cells
+#define set_render_enabled         engine_set_render_enabled
+#ifdef ENGINE_COUNTERS
+#define get_engine_counters        engine_get_engine_counters
+#endif
+#ifdef ENGINE_HASH
+#define get_state_hash             engine_get_state_hash
+#endif
+#ifdef ENGINE_UNDO
+#define undo_turn                  engine_undo_turn
+#define redo_turn                  engine_redo_turn
+#endif
+#else
+static EngineContext engine_context;
+#define ctx (&engine_context)
+
+#define CTX_VOID  void
+#define CTX_PARAM
+#define CTX_ONLY
+#define CTX_ARG
+#endif
+
+// First cell of each level row (avoids multiplying by MAP_STRIDE)
+static const byte row_cell[MAX_LEVEL_HEIGHT] = {
+    CELL(0, 0), CELL(0, 1), CELL(0, 2), CELL(0, 3), CELL(0, 4), CELL(0, 5),
+    CELL(0, 6), CELL(0, 7), CELL(0, 8), CELL(0, 9), CELL(0, 10)
+};
+
+// Column and row of every cell (the sentinel rows report -1 and MAX_LEVEL_HEIGHT)
+#define CELL_COLUMNS 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18
+#define CELL_ROW(y)  y, y, y, y, y, y, y, y, y, y, y, y, y, y, y, y, y, y, y
+
+const byte map_cell_x[MAP_CELLS] = {
+    CELL_COLUMNS, CELL_COLUMNS, CELL_COLUMNS, CELL_COLUMNS, CELL_COLUMNS,
+    CELL_COLUMNS, CELL_COLUMNS, CELL_COLUMNS, CELL_COLUMNS, CELL_COLUMNS,
+    CELL_COLUMNS, CELL_COLUMNS, CELL_COLUMNS
+};
+
+const byte map_cell_y[MAP_CELLS] = {
+    CELL_ROW(255), CELL_ROW(0), CELL_ROW(1), CELL_ROW(2), CELL_ROW(3),
+    CELL_ROW(4), CELL_ROW(5), CELL_ROW(6), CELL_ROW(7), CELL_ROW(8),
+    CELL_ROW(9), CELL_ROW(10), CELL_ROW(11)
+};
+
+// Neighbour steps in flood fill order: up, down, left, right
+static const byte dir_steps[4] = { STEP_UP, STEP_DOWN, STEP_LEFT, STEP_RIGHT };
+
+// Bit of each cell within its ctx->dirty_bits byte
+static const byte dirty_bit[8] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+
+#ifdef ENGINE_HASH
+// Zobrist keys, factored so they fit on the 6502: the key of a tile on a
+// cell is cell_keys[cell] ^ tile_keys[tile]. The board hash is the sum of
+// the keys of all cells (an XOR of factored keys would cancel the cell
+// keys out). The keys are const tables in duplicator_tile_props.h, shared
+// by all contexts.
+#define HASH_KEY(cell, tile) (cell_keys[cell] ^ tile_keys[(byte)(tile) & 0x7F])
+
+// Account for a cell of the level map changing to a new tile
+#define HASH_CELL(cell, tile) \
+    (ctx->hash += HASH_KEY(cell, tile) - HASH_KEY(cell, ctx->level_map[cell]))
+
+// Hash the whole level map from scratch
+static void rehash_level_map(CTX_VOID) {
+    byte cell;
+
+    ctx->hash = 0;
+    for (cell = 0; cell < MAP_CELLS; cell++) {
+        ctx->hash += HASH_KEY(cell, ctx->level_map[cell]);
+    }
+}
+#else
+#define HASH_CELL(cell, tile)
+#endif
+
+// Account for an entity arriving on a tile
+static void enter_tile(CTX_PARAM char under) {
+    if (under == TILE_PLATE_A) {
+        ctx->plateA_count++;
+    } else if (under == TILE_PLATE_B) {
+        ctx->plateB_count++;
+    }
+}
+
+// Account for an entity leaving a tile
+static void leave_tile(CTX_PARAM char under) {
+    if (under == TILE_PLATE_A) {
+        ctx->plateA_count--;
+    } else if (under == TILE_PLATE_B) {
+        ctx->plateB_count--;
+    } else if (is_gate(under)) {
+        ctx->gates_dirty = 1;
+    }
+}
+
+// Rebuild the occupancy index from the entity table
+static void rebuild_entity_index(CTX_VOID) {
+    byte i;
+
+    memset(ctx->entity_at, ENTITY_NONE, sizeof(ctx->entity_at));
+    for (i = 0; i < ctx->game_state.num_entities; i++) {
+        ctx->entity_at[ctx->game_state.cell[i]] = i;
+    }
+}
+
+// Check the per-kind limit before adding an entity of this type
+static byte has_room_for(CTX_PARAM char type) {
+    if (type == TILE_PLAYER) {
+        return ctx->game_state.num_players < MAX_PLAYERS;
+    }
+    return ctx->game_state.num_objects < MAX_OBJECTS;
+}
+
+// Append an entity to the table and index it (caller checks has_room_for)
+static void add_entity(CTX_PARAM byte cell, char type, char under) {
+    byte n = ctx->game_state.num_entities;
+
+    ENGINE_COUNT(entities_touched);
+    ctx->game_state.cell[n] = cell;
+    ctx->game_state.type[n] = type;
+    ctx->game_state.under[n] = under;
+    ctx->game_state.prev_under[n] = under;
+    ctx->entity_at[cell] = n;
+    enter_tile(CTX_ARG under);
+    ctx->game_state.num_entities++;
+
+    if (type == TILE_PLAYER) {
+        ctx->game_state.num_players++;
+    } else {
+        ctx->game_state.num_objects++;
+    }
+}
+
+// Take an entity off the board; its slot is reclaimed by compact_entities()
+// so that callers iterating the table keep valid indices meanwhile
+static void remove_entity(CTX_PARAM byte k) {
+    ENGINE_COUNT(entities_touched);
+    ctx->entity_at[ctx->game_state.cell[k]] = ENTITY_NONE;
+    leave_tile(CTX_ARG ctx->game_state.under[k]);
+
+    if (ctx->game_state.type[k] == TILE_PLAYER) {
+        ctx->game_state.num_players--;
+    } else {
+        ctx->game_state.num_objects--;
+    }
+    ctx->game_state.type[k] = ENTITY_REMOVED;
+}
+
+// Close the gaps left by remove_entity, keeping the survivors in table order:
+// enemies chase the first player they see in slot order, so a reshuffled
+// table would change which player gets caught
+static void compact_entities(CTX_VOID) {
+    byte i, j = 0;
+
+    for (i = 0; i < ctx->game_state.num_entities; i++) {
+        ENGINE_COUNT(entities_touched);
+        if (ctx->game_state.type[i] == ENTITY_REMOVED) {
+            continue;
+        }
+        if (i != j) {
+            ctx->game_state.cell[j] = ctx->game_state.cell[i];
+            ctx->game_state.type[j] = ctx->game_state.type[i];
+            ctx->game_state.under[j] = ctx->game_state.under[i];
+            ctx->game_state.prev_under[j] = ctx->game_state.prev_under[i];
+            ctx->entity_at[ctx->game_state.cell[j]] = j;
+        }
+        j++;
+    }
+    ctx->game_state.num_entities = j;
+}
+
+// Queue a cell for redraw (each cell at most once per flush)
+static void mark_dirty(CTX_PARAM byte cell) {
+    byte bit = dirty_bit[cell & 7];
+    byte* bits = &ctx->dirty_bits[cell >> 3];
+
+    if (*bits & bit) {
+        return;  // Already queued
+    }
+    *bits |= bit;
+
+    if (ctx->num_dirty < DIRTY_QUEUE_SIZE) {
+        ctx->dirty_queue[ctx->num_dirty++] = cell;
+    } else {
+        ctx->dirty_overflow = 1;  // Too many changes - flush redraws the level
+    }
+}
+
+// Forget all queued cells
+static void clear_dirty(CTX_VOID) {
+    memset(ctx->dirty_bits, 0, sizeof(ctx->dirty_bits));
+    ctx->num_dirty = 0;
+    ctx->dirty_overflow = 0;
+}
 
-static Position flood_queue[32];  // Reduced from 64 to 32
-static byte queue_start;
-static byte queue_end;
+#ifdef ENGINE_UNDO
+// Remember the tile a cell had before the turn being recorded changes it
+static void note_changed_cell(CTX_PARAM byte cell) {
+    byte bit = dirty_bit[cell & 7];
+    byte* bits = &ctx->undo_bits[cell >> 3];
+
+    if (*bits & bit) {
+        return;  // Already changed this turn
+    }
+    *bits |= bit;
+
+    if (ctx->undo_num_cells < UNDO_MAX_CELLS) {
+        ctx->undo_cells[ctx->undo_num_cells] = cell;
+        ctx->undo_tiles[ctx->undo_num_cells++] = ctx->level_map[cell];
+    } else {
+        ctx->undo_overflow = 1;  // Too many changes - the turn keeps only its move
+    }
+}
+
+#define UNDO_CELL(cell) do { if (ctx->undo_recording) note_changed_cell(CTX_ARG cell); } while (0)
+
+// Forget the whole timeline (the next turn starts with a keyframe)
+static void clear_undo(CTX_VOID) {
+    ctx->undo_tail = 0;
+    ctx->undo_cursor = 0;
+    ctx->undo_head = 0;
+    ctx->undo_span = UNDO_KEYFRAME_INTERVAL;
+    ctx->undo_recording = 0;
+    ctx->undo_redoing = 0;
+}
+#else
+#define UNDO_CELL(cell)
+#endif
+
+// Set a cell in the level map and queue it for redraw
+static void update_cell(CTX_PARAM byte cell, char tile) {
+    UNDO_CELL(cell);
+    HASH_CELL(cell, tile);
+    ctx->level_map[cell] = tile;
+    if (!ctx->headless) {
+        mark_dirty(CTX_ARG cell);
+    }
+}
+
+// Move an entity to a new cell: restore the tile it covered, record the
+// tile it now covers, and keep the occupancy index and counters in sync
+static void move_entity(CTX_PARAM byte k, byte new_cell, char new_under) {
+    byte old_cell = ctx->game_state.cell[k];
+
+    ENGINE_COUNT(entities_touched);
+    update_cell(CTX_ARG old_cell, ctx->game_state.under[k]);
+    ctx->entity_at[old_cell] = ENTITY_NONE;
+    leave_tile(CTX_ARG ctx->game_state.under[k]);
+
+    ctx->game_state.cell[k] = new_cell;
+    ctx->game_state.under[k] = new_under;
+    ctx->entity_at[new_cell] = k;
+    enter_tile(CTX_ARG new_under);
+    update_cell(CTX_ARG new_cell, ctx->game_state.type[k]);
+}
 
 // Forward declaration
-void reset_duplication_tracking(void);
+void reset_duplication_tracking(CTX_VOID);
 
-void load_level(const char* level_data[], byte num_rows) {
-    byte x, y;
-    const char* row;
+// Clear the maps and game state before a level is filled in
+static void clear_level(CTX_PARAM byte num_rows) {
+    byte y;
+
+    // Clear the maps, leaving walls in the sentinel column and rows
+    memset(ctx->level_map, TILE_WALL, sizeof(ctx->level_map));
+    for (y = 0; y < MAX_LEVEL_HEIGHT; y++) {
+        memset(&ctx->level_map[row_cell[y]], TILE_EMPTY, MAX_LEVEL_WIDTH);
+    }
+    memset(ctx->background_map, TILE_FLOOR, sizeof(ctx->background_map));
+    clear_dirty(CTX_ONLY);
+
+    // Reset game state
+    ctx->game_state.num_entities = 0;
+    ctx->game_state.num_players = 0;
+    ctx->game_state.num_objects = 0;
+    ctx->game_state.level_width = 0;
+    ctx->game_state.level_height = num_rows;
+    ctx->game_state.level_complete = 0;
+    ctx->num_gates = 0;
+    ctx->num_holes = 0;
+    ctx->num_plates = 0;
+    ctx->num_doors = 0;
+}
+
+// Put a level tile on a cell, separating objects from the background
+static void place_tile(CTX_PARAM byte cell, char tile) {
+    if (tile == TILE_PLAYER || is_pushable(tile)) {
+        // Object - store floor as background
+        ctx->background_map[cell] = TILE_FLOOR;
+        ctx->level_map[cell] = tile;
+    } else if (tile == 'z') {
+        // Player on holeA
+        ctx->background_map[cell] = TILE_HOLE_A;
+        ctx->level_map[cell] = TILE_PLAYER;
+    } else if (tile == 'y') {
+        // Enemy on holeB
+        ctx->background_map[cell] = TILE_HOLE_B;
+        ctx->level_map[cell] = TILE_ENEMY;
+    } else {
+        // Background tile
+        ctx->background_map[cell] = tile;
+        ctx->level_map[cell] = tile;
+    }
+}
+
+// Build the entity table and tile registries from the filled-in maps
+static void index_level(CTX_VOID) {
+    byte x, y, cell;
     char tile;
-    static byte categories_initialized = 0;
 
-    // Initialize tile categories on first call
-    if (!categories_initialized) {
-        init_tile_categories();
-        categories_initialized = 1;
+    for (y = 0; y < ctx->game_state.level_height; y++) {
+        cell = row_cell[y];
+        for (x = 0; x < ctx->game_state.level_width; x++, cell++) {
+            tile = ctx->level_map[cell];
+
+            // Players (support multiple) and pushable objects (keys, crates, enemies)
+            if ((tile == TILE_PLAYER || is_pushable(tile)) && has_room_for(CTX_ARG tile)) {
+                add_entity(CTX_ARG cell, tile, ctx->background_map[cell]);
+            }
+
+            // Register fixed-position tiles (in row-major order)
+            tile = ctx->background_map[cell];
+            if (is_gate(tile) && ctx->num_gates < MAX_GATES) {
+                ctx->gate_cells[ctx->num_gates++] = cell;
+            } else if (is_hole(tile) && ctx->num_holes < MAX_HOLES) {
+                ctx->hole_cells[ctx->num_holes++] = cell;
+            } else if (is_plate(tile) && ctx->num_plates < MAX_PLATES) {
+                ctx->plate_cells[ctx->num_plates++] = cell;
+            } else if (tile == TILE_DOOR && ctx->num_doors < MAX_DOORS) {
+                ctx->door_cells[ctx->num_doors++] = cell;
+            }
+        }
     }
 
-    // Clear the maps
-    memset(level_map, ' ', sizeof(level_map));
-    memset(background_map, '.', sizeof(background_map));
+    // Reset duplication tracking so objects already on holes don't trigger duplication
+    reset_duplication_tracking(CTX_ONLY);
 
-    // Reset game state
-    game_state.num_players = 0;
-    game_state.num_objects = 0;
-    game_state.level_width = 0;
-    game_state.level_height = num_rows;
-    game_state.level_complete = 0;
+    // Keep the starting position for restart_level
+    memcpy(ctx->pristine_map, ctx->level_map, sizeof(ctx->pristine_map));
+    ctx->pristine_state = ctx->game_state;
+}
+
+#ifdef ENGINE_LEVEL_STRINGS
+void load_level(CTX_PARAM const char* level_data[], byte num_rows) {
+    byte x, y, cell;
+    const char* row;
+
+    clear_level(CTX_ARG num_rows);
 
     // First pass: Load all tiles and separate objects from background
     for (y = 0; y < num_rows; y++) {
         row = level_data[y];
+        cell = row_cell[y];
         x = 0;
         while (row[x] != '\0' && x < MAX_LEVEL_WIDTH) {
-            tile = row[x];
-
-            // Determine if this is an object or background
-            if (tile == TILE_PLAYER || is_pushable(tile)) {
-                // Object - store floor as background
-                background_map[y][x] = TILE_FLOOR;
-                level_map[y][x] = tile;
-            } else if (tile == 'z') {
-                // Player on holeA
-                background_map[y][x] = TILE_HOLE_A;
-                level_map[y][x] = TILE_PLAYER;
-            } else if (tile == 'y') {
-                // Enemy on holeB
-                background_map[y][x] = TILE_HOLE_B;
-                level_map[y][x] = TILE_ENEMY;
-            } else {
-                // Background tile
-                background_map[y][x] = tile;
-                level_map[y][x] = tile;
-            }
-
+            place_tile(CTX_ARG cell, row[x]);
+            cell++;
             x++;
         }
 
         // Track the maximum width
-        if (x > game_state.level_width) {
-            game_state.level_width = x;
+        if (x > ctx->game_state.level_width) {
+            ctx->game_state.level_width = x;
         }
     }
 
-    // Second pass: Extract objects into arrays
-    for (y = 0; y < num_rows; y++) {
-        for (x = 0; x < game_state.level_width; x++) {
-            tile = level_map[y][x];
-
-            // Find player starting positions (support multiple players)
-            if (tile == TILE_PLAYER && game_state.num_players < MAX_PLAYERS) {
-                game_state.players[game_state.num_players].x = x;
-                game_state.players[game_state.num_players].y = y;
-                game_state.players[game_state.num_players].under = background_map[y][x];
-                game_state.num_players++;
-                level_map[y][x] = TILE_PLAYER;
+    // Second pass: Extract players and objects into the entity table
+    index_level(CTX_ONLY);
+}
+#endif
+
+#ifdef ENGINE_LEVEL_PACKED
+void load_packed_level(CTX_PARAM const byte* data) {
+    byte x, y, cell, count;
+    byte width, height;
+    byte run = 0, flip = 0, high = 0;
+    char tile = TILE_WALL;
+
+    width = *data++;
+    height = *data++;
+    clear_level(CTX_ARG height);
+    ctx->game_state.level_width = width;
+
+    // Walls and floor: runs of 0-15 cells, a nibble each (low nibble
+    // first); the kind alternates after every run shorter than 15
+    for (y = 0; y < height; y++) {
+        cell = row_cell[y];
+        for (x = 0; x < width; x++, cell++) {
+            while (run == 0) {
+                if (flip) {
+                    tile = (tile == TILE_WALL) ? TILE_FLOOR : TILE_WALL;
+                }
+                if (high) {
+                    run = *data++ >> 4;
+                } else {
+                    run = *data & 0x0F;
+                }
+                high ^= 1;
+                flip = (run != 15);
             }
-            // Track pushable objects (keys, crates, enemies)
-            else if (is_pushable(tile) && game_state.num_objects < MAX_OBJECTS) {
-                game_state.objects[game_state.num_objects].x = x;
-                game_state.objects[game_state.num_objects].y = y;
-                game_state.objects[game_state.num_objects].type = tile;
-                game_state.objects[game_state.num_objects].under = background_map[y][x];
-                game_state.num_objects++;
+            run--;
+            ctx->level_map[cell] = tile;
+            ctx->background_map[cell] = tile;
+        }
+    }
+    if (high) {
+        data++;  // Unused high nibble
+    }
+
+    // Everything else: (cell, tile) pairs in row-major order
+    for (count = *data++; count > 0; count--) {
+        cell = *data++;
+        place_tile(CTX_ARG cell, (char)*data++);
+    }
+
+    index_level(CTX_ONLY);
+}
+#endif
+
+void restart_level(CTX_VOID) {
+    byte x, y, cell;
+    byte level = ctx->game_state.current_level;
+
+    // Queue only the cells that differ from the starting position
+    if (!ctx->headless) {
+        for (y = 0; y < ctx->game_state.level_height; y++) {
+            cell = row_cell[y];
+            for (x = 0; x < ctx->game_state.level_width; x++, cell++) {
+                ENGINE_COUNT(cells_scanned);
+                if (ctx->level_map[cell] != ctx->pristine_map[cell]) {
+                    mark_dirty(CTX_ARG cell);
+                }
             }
         }
     }
 
-    // Reset duplication tracking so objects already on holes don't trigger duplication
-    reset_duplication_tracking();
+    memcpy(ctx->level_map, ctx->pristine_map, sizeof(ctx->level_map));
+    ctx->game_state = ctx->pristine_state;
+    ctx->game_state.current_level = level;
+
+    // Re-derive the index, plate counters, hole flags and hash
+    reset_duplication_tracking(CTX_ONLY);
 }
 
-void draw_level(void) {
-    byte x, y;
+void draw_level(CTX_VOID) {
+    byte x, y, cell;
     char tile;
 
-    for (y = 0; y < game_state.level_height; y++) {
-        for (x = 0; x < game_state.level_width; x++) {
-            tile = level_map[y][x];
+    // Everything queued is about to be drawn anyway
+    clear_dirty(CTX_ONLY);
+
+    for (y = 0; y < ctx->game_state.level_height; y++) {
+        cell = row_cell[y];
+        for (x = 0; x < ctx->game_state.level_width; x++) {
+            tile = ctx->level_map[cell++];
+            ENGINE_COUNT(tiles_drawn);
 
             // Draw the tile
             if (tile != TILE_EMPTY) {
@@ -176,22 +510,59 @@ void draw_level(void) {
     }
 }
 
-byte get_tile(byte x, byte y) {
+byte get_entity_at(CTX_PARAM byte x, byte y) {
+    if (x >= MAX_LEVEL_WIDTH || y >= MAX_LEVEL_HEIGHT) {
+        return ENTITY_NONE;
+    }
+    return ctx->entity_at[row_cell[y] + x];
+}
+
+byte get_tile(CTX_PARAM byte x, byte y) {
     if (x >= MAX_LEVEL_WIDTH || y >= MAX_LEVEL_HEIGHT) {
         return TILE_WALL;  // Out of bounds = wall
     }
-    return level_map[y][x];
+    return ctx->level_map[row_cell[y] + x];
 }
 
-void set_tile(byte x, byte y, byte tile) {
+void set_tile(CTX_PARAM byte x, byte y, byte tile) {
+    byte cell;
+
     if (x < MAX_LEVEL_WIDTH && y < MAX_LEVEL_HEIGHT) {
-        level_map[y][x] = tile;
+        cell = row_cell[y] + x;
+        HASH_CELL(cell, tile);
+        ctx->level_map[cell] = tile;
     }
 }
 
-void set_tile_and_draw(byte x, byte y, char tile) {
-    set_tile(x, y, tile);
-    my_cputcxy(x, y + SCREEN_TOP_MARGIN, tile);
+void set_tile_and_draw(CTX_PARAM byte x, byte y, char tile) {
+    if (x < MAX_LEVEL_WIDTH && y < MAX_LEVEL_HEIGHT) {
+        update_cell(CTX_ARG row_cell[y] + x, tile);
+    }
+}
+
+void set_render_enabled(CTX_PARAM byte enabled) {
+    ctx->headless = !enabled;
+    if (ctx->headless) {
+        clear_dirty(CTX_ONLY);
+    }
+}
+
+byte flush_dirty_cells(CTX_VOID) {
+    byte i, cell;
+    byte count = ctx->num_dirty;
+
+    if (ctx->dirty_overflow) {
+        draw_level(CTX_ONLY);
+        return count;
+    }
+
+    for (i = 0; i < ctx->num_dirty; i++) {
+        cell = ctx->dirty_queue[i];
+        ENGINE_COUNT(tiles_drawn);
+        my_cputcxy(cell_x(cell), cell_y(cell) + SCREEN_TOP_MARGIN, ctx->level_map[cell]);
+    }
+    clear_dirty(CTX_ONLY);
+    return count;
 }
 
 byte is_blocking(char tile) {
@@ -204,531 +575,280 @@ byte is_passable(char tile) {
 
 // is_exit and is_pushable are now macros in the header file
 
-void door_flood_fill(byte x, byte y) {
-    byte cx, cy, nx, ny;
-    char tile;
-    char dx, dy, i;
+void door_flood_fill(CTX_PARAM byte cell) {
+    byte current, next, i;
 
-    queue_start = 0;
-    queue_end = 0;
-    flood_queue[queue_end].x = x;
-    flood_queue[queue_end].y = y;
-    queue_end++;
-    set_tile(x, y, TILE_DOOR_OPEN);
+    ctx->queue_start = 0;
+    ctx->queue_end = 0;
+    ctx->flood_queue[ctx->queue_end++] = cell;
+    UNDO_CELL(cell);
+    HASH_CELL(cell, TILE_DOOR_OPEN);
+    ctx->level_map[cell] = TILE_DOOR_OPEN;
 
-    while (queue_start != queue_end) {
-        cx = flood_queue[queue_start].x;
-        cy = flood_queue[queue_start].y;
-        queue_start++;
+    while (ctx->queue_start != ctx->queue_end) {
+        current = ctx->flood_queue[ctx->queue_start++];
 
         // Check 4 directions: up, down, left, right
         for (i = 0; i < 4; i++) {
-            dx = (i == 2) ? -1 : (i == 3) ? 1 : 0;
-            dy = (i == 0) ? -1 : (i == 1) ? 1 : 0;
-            nx = cx + dx;
-            ny = cy + dy;
-
-            if (nx < MAX_LEVEL_WIDTH && ny < MAX_LEVEL_HEIGHT) {
-                tile = get_tile(nx, ny);
-                if (tile == TILE_DOOR) {
-                    set_tile(nx, ny, TILE_DOOR_OPEN);
-                    flood_queue[queue_end].x = nx;
-                    flood_queue[queue_end].y = ny;
-                    queue_end++;
-                }
+            next = current + dir_steps[i];
+            ENGINE_COUNT(cells_scanned);
+            if (ctx->level_map[next] == TILE_DOOR) {
+                UNDO_CELL(next);
+                HASH_CELL(next, TILE_DOOR_OPEN);
+                ctx->level_map[next] = TILE_DOOR_OPEN;
+                ctx->flood_queue[ctx->queue_end++] = next;
             }
         }
     }
 }
 
-void remove_open_doors(void) {
-    byte x, y;
+void remove_open_doors(CTX_VOID) {
+    byte i, cell;
 
-    // Scan entire level and remove all door_open tiles
-    for (y = 0; y < game_state.level_height; y++) {
-        for (x = 0; x < game_state.level_width; x++) {
-            if (get_tile(x, y) == TILE_DOOR_OPEN) {
-                set_tile_and_draw(x, y, TILE_FLOOR);
-            }
+    // Walk the door registry and remove all door_open tiles
+    for (i = 0; i < ctx->num_doors; i++) {
+        cell = ctx->door_cells[i];
+        ENGINE_COUNT(cells_scanned);
+        if (ctx->level_map[cell] == TILE_DOOR_OPEN) {
+            update_cell(CTX_ARG cell, TILE_FLOOR);
         }
     }
 }
 
-void handle_key_door(byte key_x, byte key_y, byte door_x, byte door_y, char tile_under_key) {
+void handle_key_door(CTX_PARAM byte key_cell, byte door_cell, char tile_under_key) {
     // Remove key and restore the tile that was under it
-    set_tile_and_draw(key_x, key_y, tile_under_key);
+    update_cell(CTX_ARG key_cell, tile_under_key);
 
     // Start flood fill from the door
-    door_flood_fill(door_x, door_y);
+    door_flood_fill(CTX_ARG door_cell);
 
     // Remove all open doors
-    remove_open_doors();
+    remove_open_doors(CTX_ONLY);
 }
 
-void update_gates(void) {
-    byte x, y, i;
+void update_gates(CTX_VOID) {
+    byte cell, i;
     char tile;
-    byte plateA_has_object = 0;
-    byte plateB_has_object = 0;
+    byte plateA_has_object = (ctx->plateA_count != 0);
+    byte plateB_has_object = (ctx->plateB_count != 0);
 
-    // Check if any player is on a plate
-    for (i = 0; i < game_state.num_players; i++) {
-        if (game_state.players[i].under == TILE_PLATE_A) {
-            plateA_has_object = 1;
-        }
-        if (game_state.players[i].under == TILE_PLATE_B) {
-            plateB_has_object = 1;
-        }
-    }
-
-    // Check if any movable object (key, crate, enemy) is on a plate
-    for (i = 0; i < game_state.num_objects; i++) {
-        if (game_state.objects[i].under == TILE_PLATE_A) {
-            plateA_has_object = 1;
-        }
-        if (game_state.objects[i].under == TILE_PLATE_B) {
-            plateB_has_object = 1;
-        }
+    // Nothing to do unless a plate counter crossed zero since the last
+    // update or an entity uncovered a gate that may be out of date
+    if (plateA_has_object == ctx->gateA_open && plateB_has_object == ctx->gateB_open && !ctx->gates_dirty) {
+        return;
     }
+    ctx->gateA_open = plateA_has_object;
+    ctx->gateB_open = plateB_has_object;
+    ctx->gates_dirty = 0;
 
     // Update gates based on plate states
-    for (y = 0; y < game_state.level_height; y++) {
-        for (x = 0; x < game_state.level_width; x++) {
-            tile = get_tile(x, y);
-
-            // Update gateA
-            if (tile == TILE_GATE_A || tile == 'G') {
-                if (plateA_has_object) {
-                    // Open gate
-                    if (tile != 'G') {
-                        set_tile_and_draw(x, y, 'G');
-                    }
-                } else {
-                    // Close gate
-                    if (tile != TILE_GATE_A) {
-                        set_tile_and_draw(x, y, TILE_GATE_A);
-                    }
+    for (i = 0; i < ctx->num_gates; i++) {
+        cell = ctx->gate_cells[i];
+        tile = ctx->level_map[cell];
+        ENGINE_COUNT(cells_scanned);
+
+        // Update gateA
+        if (tile == TILE_GATE_A || tile == 'G') {
+            if (plateA_has_object) {
+                // Open gate
+                if (tile != 'G') {
+                    update_cell(CTX_ARG cell, 'G');
+                }
+            } else {
+                // Close gate
+                if (tile != TILE_GATE_A) {
+                    update_cell(CTX_ARG cell, TILE_GATE_A);
                 }
             }
+        }
 
-            // Update gateB
-            if (tile == TILE_GATE_B || tile == 'H') {
-                if (plateB_has_object) {
-                    // Open gate
-                    if (tile != 'H') {
-                        set_tile_and_draw(x, y, 'H');
-                    }
-                } else {
-                    // Close gate
-                    if (tile != TILE_GATE_B) {
-                        set_tile_and_draw(x, y, TILE_GATE_B);
-                    }
+        // Update gateB
+        if (tile == TILE_GATE_B || tile == 'H') {
+            if (plateB_has_object) {
+                // Open gate
+                if (tile != 'H') {
+                    update_cell(CTX_ARG cell, 'H');
+                }
+            } else {
+                // Close gate
+                if (tile != TILE_GATE_B) {
+                    update_cell(CTX_ARG cell, TILE_GATE_B);
                 }
             }
         }
     }
 }
 
-// Static arrays to track previous 'under' state for duplication detection
-static char prev_player_under[MAX_PLAYERS];
-static char prev_object_under[MAX_OBJECTS];
+// Recompute which holes currently hold an entity
+static void update_hole_occupancy(CTX_VOID) {
+    byte i;
 
-// Track which holes had objects in the previous turn
-// This prevents duplication when objects move OUT of holes
-static byte prev_holeA_occupied = 0;
-static byte prev_holeB_occupied = 0;
+    ctx->prev_holeA_occupied = 0;
+    ctx->prev_holeB_occupied = 0;
+    for (i = 0; i < ctx->game_state.num_entities; i++) {
+        ENGINE_COUNT(entities_touched);
+        if (ctx->game_state.under[i] == TILE_HOLE_A) ctx->prev_holeA_occupied = 1;
+        if (ctx->game_state.under[i] == TILE_HOLE_B) ctx->prev_holeB_occupied = 1;
+    }
+}
 
 // Reset duplication tracking (call when loading a new level)
-void reset_duplication_tracking(void) {
+void reset_duplication_tracking(CTX_VOID) {
     byte i;
 
-    // Initialize ALL entries to prevent stale data
-    for (i = 0; i < MAX_PLAYERS; i++) {
-        prev_player_under[i] = TILE_FLOOR;
-    }
-    for (i = 0; i < MAX_OBJECTS; i++) {
-        prev_object_under[i] = TILE_FLOOR;
+    // Set current state for existing players/objects
+    for (i = 0; i < ctx->game_state.num_entities; i++) {
+        ctx->game_state.prev_under[i] = ctx->game_state.under[i];
     }
 
-    // Then set current state for existing players/objects
-    for (i = 0; i < game_state.num_players; i++) {
-        prev_player_under[i] = game_state.players[i].under;
-    }
-    for (i = 0; i < game_state.num_objects; i++) {
-        prev_object_under[i] = game_state.objects[i].under;
+    // Positions may have been edited by hand, so re-derive the occupancy
+    // index and plate counters, and reconcile every gate on the next update
+    rebuild_entity_index(CTX_ONLY);
+    ctx->plateA_count = 0;
+    ctx->plateB_count = 0;
+    for (i = 0; i < ctx->game_state.num_entities; i++) {
+        enter_tile(CTX_ARG ctx->game_state.under[i]);
     }
+    ctx->gates_dirty = 1;
 
     // Check if holes are currently occupied
-    prev_holeA_occupied = 0;
-    prev_holeB_occupied = 0;
-    for (i = 0; i < game_state.num_players; i++) {
-        if (game_state.players[i].under == TILE_HOLE_A) prev_holeA_occupied = 1;
-        if (game_state.players[i].under == TILE_HOLE_B) prev_holeB_occupied = 1;
-    }
-    for (i = 0; i < game_state.num_objects; i++) {
-        if (game_state.objects[i].under == TILE_HOLE_A) prev_holeA_occupied = 1;
-        if (game_state.objects[i].under == TILE_HOLE_B) prev_holeB_occupied = 1;
-    }
+    update_hole_occupancy(CTX_ONLY);
+
+#ifdef ENGINE_HASH
+    rehash_level_map(CTX_ONLY);
+#endif
+#ifdef ENGINE_UNDO
+    // The position no longer follows from the recorded turns
+    clear_undo(CTX_ONLY);
+#endif
 }
 
 // Optimized duplication handler
 // Only triggers if something ENTERED a hole (moved from non-hole to hole)
 // AND the hole was empty in the previous turn
-void handle_duplication(void) {
-    byte i, j, x, y;
-    byte player_holeA = 0, player_holeB = 0;
-    byte key_holeA = 0, key_holeB = 0;
-    byte crate_holeA = 0, crate_holeB = 0;
-    byte enemy_holeA = 0, enemy_holeB = 0;
-    byte total_player_holeA = 0, total_player_holeB = 0;
-    byte total_key_holeA = 0, total_key_holeB = 0;
-    byte total_crate_holeA = 0, total_crate_holeB = 0;
-    byte total_enemy_holeA = 0, total_enemy_holeB = 0;
-    byte curr_holeA_occupied = 0, curr_holeB_occupied = 0;
+// Players, keys, crates and enemies are handled by one table-driven pass,
+// in tile_dup_types order
+void handle_duplication(CTX_VOID) {
+    byte i, c, cell;
+    byte entered_holeA[DUP_CLASSES];
+    byte entered_holeB[DUP_CLASSES];
+    byte total_holeA[DUP_CLASSES];
+    byte total_holeB[DUP_CLASSES];
     char current_under, previous_under;
+    char tile;
 
-    // Count players that JUST ENTERED each hole type (not already on it)
-    // Only count if the hole was EMPTY in the previous turn
-    for (i = 0; i < game_state.num_players; i++) {
-        current_under = game_state.players[i].under;
-        previous_under = prev_player_under[i];
+    memset(entered_holeA, 0, sizeof(entered_holeA));
+    memset(entered_holeB, 0, sizeof(entered_holeB));
+    memset(total_holeA, 0, sizeof(total_holeA));
+    memset(total_holeB, 0, sizeof(total_holeB));
 
-        // Only count if player just moved ONTO a hole (wasn't on a hole before)
-        // AND the hole was empty in the previous turn
-        if (current_under == TILE_HOLE_A && !is_hole(previous_under) && !prev_holeA_occupied) {
-            player_holeA++;
-        }
-        if (current_under == TILE_HOLE_B && !is_hole(previous_under) && !prev_holeB_occupied) {
-            player_holeB++;
-        }
+    // Count entities that JUST ENTERED each hole type (not already on it),
+    // and all entities standing on each hole type (for the disappearing check)
+    for (i = 0; i < ctx->game_state.num_entities; i++) {
+        ENGINE_COUNT(entities_touched);
+        c = tile_dup_class[(byte)ctx->game_state.type[i]];
+        current_under = ctx->game_state.under[i];
+        previous_under = ctx->game_state.prev_under[i];
 
-        // Update previous state for next turn
-        prev_player_under[i] = current_under;
-    }
-
-    // Count keys, crates, and enemies that JUST ENTERED each hole type (not already on it)
-    // Only count if the hole was EMPTY in the previous turn
-    for (i = 0; i < game_state.num_objects; i++) {
-        current_under = game_state.objects[i].under;
-        previous_under = prev_object_under[i];
-
-        if (game_state.objects[i].type == TILE_KEY) {
-            // Only count if key just moved ONTO a hole (wasn't on a hole before)
-            // AND the hole was empty in the previous turn
-            if (current_under == TILE_HOLE_A && !is_hole(previous_under) && !prev_holeA_occupied) {
-                key_holeA++;
-            }
-            if (current_under == TILE_HOLE_B && !is_hole(previous_under) && !prev_holeB_occupied) {
-                key_holeB++;
-            }
-        } else if (game_state.objects[i].type == TILE_CRATE) {
-            // Only count if crate just moved ONTO a hole (wasn't on a hole before)
-            // AND the hole was empty in the previous turn
-            if (current_under == TILE_HOLE_A && !is_hole(previous_under) && !prev_holeA_occupied) {
-                crate_holeA++;
-            }
-            if (current_under == TILE_HOLE_B && !is_hole(previous_under) && !prev_holeB_occupied) {
-                crate_holeB++;
-            }
-        } else if (game_state.objects[i].type == TILE_ENEMY) {
-            // Only count if enemy just moved ONTO a hole (wasn't on a hole before)
-            // AND the hole was empty in the previous turn
-            if (current_under == TILE_HOLE_A && !is_hole(previous_under) && !prev_holeA_occupied) {
-                enemy_holeA++;
+        // Only count if the entity just moved ONTO a hole (wasn't on a hole before)
+        // AND the hole was empty in the previous turn
+        if (current_under == TILE_HOLE_A) {
+            total_holeA[c]++;
+            if (!is_hole(previous_under) && !ctx->prev_holeA_occupied) {
+                entered_holeA[c]++;
             }
-            if (current_under == TILE_HOLE_B && !is_hole(previous_under) && !prev_holeB_occupied) {
-                enemy_holeB++;
+        } else if (current_under == TILE_HOLE_B) {
+            total_holeB[c]++;
+            if (!is_hole(previous_under) && !ctx->prev_holeB_occupied) {
+                entered_holeB[c]++;
             }
         }
 
         // Update previous state for next turn
-        prev_object_under[i] = current_under;
-    }
-
-    // Count total objects on holes (for disappearing check)
-    for (i = 0; i < game_state.num_players; i++) {
-        if (game_state.players[i].under == TILE_HOLE_A) total_player_holeA++;
-        if (game_state.players[i].under == TILE_HOLE_B) total_player_holeB++;
-    }
-
-    for (i = 0; i < game_state.num_objects; i++) {
-        if (game_state.objects[i].type == TILE_KEY) {
-            if (game_state.objects[i].under == TILE_HOLE_A) total_key_holeA++;
-            if (game_state.objects[i].under == TILE_HOLE_B) total_key_holeB++;
-        } else if (game_state.objects[i].type == TILE_CRATE) {
-            if (game_state.objects[i].under == TILE_HOLE_A) total_crate_holeA++;
-            if (game_state.objects[i].under == TILE_HOLE_B) total_crate_holeB++;
-        } else if (game_state.objects[i].type == TILE_ENEMY) {
-            if (game_state.objects[i].under == TILE_HOLE_A) total_enemy_holeA++;
-            if (game_state.objects[i].under == TILE_HOLE_B) total_enemy_holeB++;
-        }
-    }
-
-    // If a player just entered a hole AND both holes now have players, they disappear
-    if ((player_holeA > 0 || player_holeB > 0) && total_player_holeA > 0 && total_player_holeB > 0) {
-        j = 0;
-        for (i = 0; i < game_state.num_players; i++) {
-            if (!is_hole(game_state.players[i].under)) {
-                game_state.players[j] = game_state.players[i];
-                prev_player_under[j] = prev_player_under[i];
-                j++;
-            } else {
-                set_tile_and_draw(game_state.players[i].x, game_state.players[i].y, game_state.players[i].under);
-            }
-        }
-        game_state.num_players = j;
-        if (game_state.num_players == 0) {
-            game_state.level_complete = 1;
-        }
-        return;
-    }
-
-    // If a key just entered a hole AND both holes now have keys, they disappear
-    if ((key_holeA > 0 || key_holeB > 0) && total_key_holeA > 0 && total_key_holeB > 0) {
-        j = 0;
-        for (i = 0; i < game_state.num_objects; i++) {
-            if (game_state.objects[i].type != TILE_KEY || !is_hole(game_state.objects[i].under)) {
-                game_state.objects[j] = game_state.objects[i];
-                prev_object_under[j] = prev_object_under[i];
-                j++;
-            } else {
-                set_tile_and_draw(game_state.objects[i].x, game_state.objects[i].y, game_state.objects[i].under);
-            }
-        }
-        game_state.num_objects = j;
-        return;
+        ctx->game_state.prev_under[i] = current_under;
     }
 
-    // If a crate just entered a hole AND both holes now have crates, they disappear
-    if ((crate_holeA > 0 || crate_holeB > 0) && total_crate_holeA > 0 && total_crate_holeB > 0) {
-        j = 0;
-        for (i = 0; i < game_state.num_objects; i++) {
-            if (game_state.objects[i].type != TILE_CRATE || !is_hole(game_state.objects[i].under)) {
-                game_state.objects[j] = game_state.objects[i];
-                prev_object_under[j] = prev_object_under[i];
-                j++;
-            } else {
-                set_tile_and_draw(game_state.objects[i].x, game_state.objects[i].y, game_state.objects[i].under);
-            }
-        }
-        game_state.num_objects = j;
-        return;
-    }
-
-    // If an enemy just entered a hole AND both holes now have enemies, they disappear
-    if ((enemy_holeA > 0 || enemy_holeB > 0) && total_enemy_holeA > 0 && total_enemy_holeB > 0) {
-        j = 0;
-        for (i = 0; i < game_state.num_objects; i++) {
-            if (game_state.objects[i].type != TILE_ENEMY || !is_hole(game_state.objects[i].under)) {
-                game_state.objects[j] = game_state.objects[i];
-                prev_object_under[j] = prev_object_under[i];
-                j++;
-            } else {
-                set_tile_and_draw(game_state.objects[i].x, game_state.objects[i].y, game_state.objects[i].under);
-            }
-        }
-        game_state.num_objects = j;
-        return;
-    }
-
-    // Duplicate players
-    if (game_state.num_players < MAX_PLAYERS) {
-        for (y = 0; y < game_state.level_height; y++) {
-            for (x = 0; x < game_state.level_width; x++) {
-                char tile = get_tile(x, y);
-                if (tile == TILE_HOLE_A && player_holeB > 0 && game_state.num_players < MAX_PLAYERS) {
-                    game_state.players[game_state.num_players].x = x;
-                    game_state.players[game_state.num_players].y = y;
-                    game_state.players[game_state.num_players].under = TILE_HOLE_A;
-                    set_tile_and_draw(x, y, TILE_PLAYER);
-                    prev_player_under[game_state.num_players] = TILE_HOLE_A;
-                    game_state.num_players++;
-                    player_holeA++;
-                }
-                else if (tile == TILE_HOLE_B && player_holeA > 0 && game_state.num_players < MAX_PLAYERS) {
-                    game_state.players[game_state.num_players].x = x;
-                    game_state.players[game_state.num_players].y = y;
-                    game_state.players[game_state.num_players].under = TILE_HOLE_B;
-                    set_tile_and_draw(x, y, TILE_PLAYER);
-                    prev_player_under[game_state.num_players] = TILE_HOLE_B;
-                    game_state.num_players++;
-                    player_holeB++;
+    // If something just entered a hole AND both holes now hold that type, they disappear
+    for (c = 0; c < DUP_CLASSES; c++) {
+        if ((entered_holeA[c] > 0 || entered_holeB[c] > 0) && total_holeA[c] > 0 && total_holeB[c] > 0) {
+            for (i = 0; i < ctx->game_state.num_entities; i++) {
+                ENGINE_COUNT(entities_touched);
+                if (ctx->game_state.type[i] == tile_dup_types[c] && is_hole(ctx->game_state.under[i])) {
+                    update_cell(CTX_ARG ctx->game_state.cell[i], ctx->game_state.under[i]);
+                    remove_entity(CTX_ARG i);
                 }
             }
-        }
-    }
+            compact_entities(CTX_ONLY);
 
-    // Duplicate keys
-    if (game_state.num_objects < MAX_OBJECTS) {
-        for (y = 0; y < game_state.level_height; y++) {
-            for (x = 0; x < game_state.level_width; x++) {
-                char tile = get_tile(x, y);
-                if (tile == TILE_HOLE_A && key_holeB > 0 && game_state.num_objects < MAX_OBJECTS) {
-                    game_state.objects[game_state.num_objects].x = x;
-                    game_state.objects[game_state.num_objects].y = y;
-                    game_state.objects[game_state.num_objects].type = TILE_KEY;
-                    game_state.objects[game_state.num_objects].under = TILE_HOLE_A;
-                    set_tile_and_draw(x, y, TILE_KEY);
-                    prev_object_under[game_state.num_objects] = TILE_HOLE_A;
-                    game_state.num_objects++;
-                    key_holeA++;
-                }
-                else if (tile == TILE_HOLE_B && key_holeA > 0 && game_state.num_objects < MAX_OBJECTS) {
-                    game_state.objects[game_state.num_objects].x = x;
-                    game_state.objects[game_state.num_objects].y = y;
-                    game_state.objects[game_state.num_objects].type = TILE_KEY;
-                    game_state.objects[game_state.num_objects].under = TILE_HOLE_B;
-                    set_tile_and_draw(x, y, TILE_KEY);
-                    prev_object_under[game_state.num_objects] = TILE_HOLE_B;
-                    game_state.num_objects++;
-                    key_holeB++;
-                }
+            // Both players leaving through the holes completes the level
+            if (tile_dup_types[c] == TILE_PLAYER && ctx->game_state.num_players == 0) {
+                ctx->game_state.level_complete = 1;
             }
+            return;
         }
     }
 
-    // Duplicate crates
-    if (game_state.num_objects < MAX_OBJECTS) {
-        for (y = 0; y < game_state.level_height; y++) {
-            for (x = 0; x < game_state.level_width; x++) {
-                char tile = get_tile(x, y);
-                if (tile == TILE_HOLE_A && crate_holeB > 0 && game_state.num_objects < MAX_OBJECTS) {
-                    game_state.objects[game_state.num_objects].x = x;
-                    game_state.objects[game_state.num_objects].y = y;
-                    game_state.objects[game_state.num_objects].type = TILE_CRATE;
-                    game_state.objects[game_state.num_objects].under = TILE_HOLE_A;
-                    set_tile_and_draw(x, y, TILE_CRATE);
-                    prev_object_under[game_state.num_objects] = TILE_HOLE_A;
-                    game_state.num_objects++;
-                    crate_holeA++;
-                }
-                else if (tile == TILE_HOLE_B && crate_holeA > 0 && game_state.num_objects < MAX_OBJECTS) {
-                    game_state.objects[game_state.num_objects].x = x;
-                    game_state.objects[game_state.num_objects].y = y;
-                    game_state.objects[game_state.num_objects].type = TILE_CRATE;
-                    game_state.objects[game_state.num_objects].under = TILE_HOLE_B;
-                    set_tile_and_draw(x, y, TILE_CRATE);
-                    prev_object_under[game_state.num_objects] = TILE_HOLE_B;
-                    game_state.num_objects++;
-                    crate_holeB++;
-                }
-            }
+    // Duplicate into the paired hole of whatever entered the other one
+    for (c = 0; c < DUP_CLASSES; c++) {
+        if (!has_room_for(CTX_ARG tile_dup_types[c])) {
+            continue;
         }
-    }
-
-    // Duplicate enemies
-    if (game_state.num_objects < MAX_OBJECTS) {
-        for (y = 0; y < game_state.level_height; y++) {
-            for (x = 0; x < game_state.level_width; x++) {
-                char tile = get_tile(x, y);
-                if (tile == TILE_HOLE_A && enemy_holeB > 0 && game_state.num_objects < MAX_OBJECTS) {
-                    game_state.objects[game_state.num_objects].x = x;
-                    game_state.objects[game_state.num_objects].y = y;
-                    game_state.objects[game_state.num_objects].type = TILE_ENEMY;
-                    game_state.objects[game_state.num_objects].under = TILE_HOLE_A;
-                    set_tile_and_draw(x, y, TILE_ENEMY);
-                    prev_object_under[game_state.num_objects] = TILE_HOLE_A;
-                    game_state.num_objects++;
-                    enemy_holeA++;
-                }
-                else if (tile == TILE_HOLE_B && enemy_holeA > 0 && game_state.num_objects < MAX_OBJECTS) {
-                    game_state.objects[game_state.num_objects].x = x;
-                    game_state.objects[game_state.num_objects].y = y;
-                    game_state.objects[game_state.num_objects].type = TILE_ENEMY;
-                    game_state.objects[game_state.num_objects].under = TILE_HOLE_B;
-                    set_tile_and_draw(x, y, TILE_ENEMY);
-                    prev_object_under[game_state.num_objects] = TILE_HOLE_B;
-                    game_state.num_objects++;
-                    enemy_holeB++;
-                }
+        for (i = 0; i < ctx->num_holes; i++) {
+            cell = ctx->hole_cells[i];
+            tile = ctx->level_map[cell];
+            ENGINE_COUNT(cells_scanned);
+            if (tile == TILE_HOLE_A && entered_holeB[c] > 0 && has_room_for(CTX_ARG tile_dup_types[c])) {
+                add_entity(CTX_ARG cell, tile_dup_types[c], TILE_HOLE_A);
+                update_cell(CTX_ARG cell, tile_dup_types[c]);
+                entered_holeA[c]++;
+            }
+            else if (tile == TILE_HOLE_B && entered_holeA[c] > 0 && has_room_for(CTX_ARG tile_dup_types[c])) {
+                add_entity(CTX_ARG cell, tile_dup_types[c], TILE_HOLE_B);
+                update_cell(CTX_ARG cell, tile_dup_types[c]);
+                entered_holeB[c]++;
             }
         }
     }
 
     // Update hole occupation tracking for next turn
-    // Check if any holes are currently occupied
-    curr_holeA_occupied = 0;
-    curr_holeB_occupied = 0;
-    for (i = 0; i < game_state.num_players; i++) {
-        if (game_state.players[i].under == TILE_HOLE_A) curr_holeA_occupied = 1;
-        if (game_state.players[i].under == TILE_HOLE_B) curr_holeB_occupied = 1;
-    }
-    for (i = 0; i < game_state.num_objects; i++) {
-        if (game_state.objects[i].under == TILE_HOLE_A) curr_holeA_occupied = 1;
-        if (game_state.objects[i].under == TILE_HOLE_B) curr_holeB_occupied = 1;
-    }
-    prev_holeA_occupied = curr_holeA_occupied;
-    prev_holeB_occupied = curr_holeB_occupied;
+    update_hole_occupancy(CTX_ONLY);
 }
 
 /*
   Check if enemy can see player in a straight line (line-of-sight)
-  Returns 1 if line-of-sight exists, 0 otherwise
-  Sets dx/dy to movement direction if line-of-sight exists
+  Returns the cell step toward the player if line-of-sight exists, 0 otherwise
 */
-byte has_line_of_sight(byte enemy_x, byte enemy_y, byte player_x, byte player_y, signed char* dx, signed char* dy) {
-    byte x, y;
+static byte has_line_of_sight(CTX_PARAM byte enemy_cell, byte player_cell) {
+    byte step;
+    byte cell;
     char tile;
 
-    *dx = 0;
-    *dy = 0;
-
-    // Check vertical line-of-sight
-    if (enemy_x == player_x) {
-        if (enemy_y < player_y) {
-            // Check path downward
-            for (y = enemy_y + 1; y < player_y; y++) {
-                tile = get_tile(enemy_x, y);
-                // enemySeen = enemy or walls or door or gateA_closed or gateB_closed
-                if (!is_passable(tile) || tile == TILE_ENEMY || tile == TILE_DOOR ||
-                    tile == TILE_GATE_A || tile == TILE_GATE_B) {
-                    return 0;  // Path blocked
-                }
-            }
-            *dy = 1;  // Move down
-            return 1;
-        } else if (enemy_y > player_y) {
-            // Check path upward
-            for (y = player_y + 1; y < enemy_y; y++) {
-                tile = get_tile(enemy_x, y);
-                if (!is_passable(tile) || tile == TILE_ENEMY || tile == TILE_DOOR ||
-                    tile == TILE_GATE_A || tile == TILE_GATE_B) {
-                    return 0;  // Path blocked
-                }
-            }
-            *dy = -1;  // Move up
-            return 1;
+    // Only straight lines count: pick the step that leads to the player
+    if (cell_x(enemy_cell) == cell_x(player_cell)) {
+        if (enemy_cell < player_cell) {
+            step = STEP_DOWN;
+        } else if (enemy_cell > player_cell) {
+            step = STEP_UP;
+        } else {
+            return 0;
         }
+    } else if (cell_y(enemy_cell) == cell_y(player_cell)) {
+        step = (enemy_cell < player_cell) ? STEP_RIGHT : STEP_LEFT;
+    } else {
+        return 0;  // No line-of-sight
     }
 
-    // Check horizontal line-of-sight
-    if (enemy_y == player_y) {
-        if (enemy_x < player_x) {
-            // Check path rightward
-            for (x = enemy_x + 1; x < player_x; x++) {
-                tile = get_tile(x, enemy_y);
-                if (!is_passable(tile) || tile == TILE_ENEMY || tile == TILE_DOOR ||
-                    tile == TILE_GATE_A || tile == TILE_GATE_B) {
-                    return 0;  // Path blocked
-                }
-            }
-            *dx = 1;  // Move right
-            return 1;
-        } else if (enemy_x > player_x) {
-            // Check path leftward
-            for (x = player_x + 1; x < enemy_x; x++) {
-                tile = get_tile(x, enemy_y);
-                if (!is_passable(tile) || tile == TILE_ENEMY || tile == TILE_DOOR ||
-                    tile == TILE_GATE_A || tile == TILE_GATE_B) {
-                    return 0;  // Path blocked
-                }
-            }
-            *dx = -1;  // Move left
-            return 1;
+    // Check the path between enemy and player
+    for (cell = enemy_cell + step; cell != player_cell; cell += step) {
+        tile = ctx->level_map[cell];
+        ENGINE_COUNT(cells_scanned);
+        // enemySeen = enemy or walls or door or gateA_closed or gateB_closed
+        if (is_enemy_stopper(tile)) {
+            return 0;  // Path blocked
         }
     }
 
-    return 0;  // No line-of-sight
+    return step;
 }
 
 /*
@@ -737,25 +857,24 @@ byte has_line_of_sight(byte enemy_x, byte enemy_y, byte player_x, byte player_y,
   Enemies move ALL THE WAY to the player or until blocked (simulates "again" rule).
   After killing a player, enemy checks again for more players to kill (chain kills).
 */
-void move_enemies(void) {
-    byte i, j, k;
-    byte enemy_x, enemy_y;
-    signed char dx, dy;
-    byte new_x, new_y;
+void move_enemies(CTX_VOID) {
+    byte i, j;
+    byte occupant;
+    byte enemy_cell, new_cell;
+    byte step;
     char new_tile;
-    byte can_see;
     byte player_caught;
     byte keep_checking;
     char tile_under_player;
 
     // Process each enemy
-    for (i = 0; i < game_state.num_objects; i++) {
-        if (game_state.objects[i].type != TILE_ENEMY) {
-            continue;  // Skip non-enemy objects
+    for (i = 0; i < ctx->game_state.num_entities; i++) {
+        ENGINE_COUNT(entities_touched);
+        if (ctx->game_state.type[i] != TILE_ENEMY) {
+            continue;  // Skip players and non-enemy objects
         }
 
-        enemy_x = game_state.objects[i].x;
-        enemy_y = game_state.objects[i].y;
+        enemy_cell = ctx->game_state.cell[i];
 
         // Keep checking for players until no more are visible
         keep_checking = 1;
@@ -763,67 +882,50 @@ void move_enemies(void) {
             keep_checking = 0;  // Assume no more players visible
 
             // Check line-of-sight to any player
-            can_see = 0;
-            for (j = 0; j < game_state.num_players; j++) {
-                if (has_line_of_sight(enemy_x, enemy_y,
-                                      game_state.players[j].x, game_state.players[j].y,
-                                      &dx, &dy)) {
-                    can_see = 1;
-                    break;  // Found a player in line-of-sight
+            step = 0;
+            for (j = 0; j < ctx->game_state.num_entities; j++) {
+                ENGINE_COUNT(entities_touched);
+                if (ctx->game_state.type[j] == TILE_PLAYER) {
+                    step = has_line_of_sight(CTX_ARG enemy_cell, ctx->game_state.cell[j]);
+                    if (step) {
+                        break;  // Found a player in line-of-sight
+                    }
                 }
             }
 
             // If enemy can see a player, move ALL THE WAY toward them (simulates "again")
-            if (can_see && (dx != 0 || dy != 0)) {
+            if (step) {
                 // Keep moving until blocked or reach player
                 while (1) {
-                    new_x = enemy_x + dx;
-                    new_y = enemy_y + dy;
-
-                    // Check bounds
-                    if (new_x >= MAX_LEVEL_WIDTH || new_y >= MAX_LEVEL_HEIGHT) {
-                        break;
-                    }
-
-                    new_tile = get_tile(new_x, new_y);
+                    new_cell = enemy_cell + step;
+                    new_tile = ctx->level_map[new_cell];
+                    ENGINE_COUNT(cells_scanned);
 
                     // Check if there's a player at this position
                     player_caught = 0;
-                    for (k = 0; k < game_state.num_players; k++) {
-                        if (game_state.players[k].x == new_x && game_state.players[k].y == new_y) {
-                            player_caught = 1;
-
-                            // Save what was under the player (not the player itself!)
-                            tile_under_player = game_state.players[k].under;
-
-                            // Remove the caught player (like disappearing in duplication)
-                            // Shift remaining players down
-                            for (j = k; j < game_state.num_players - 1; j++) {
-                                game_state.players[j] = game_state.players[j + 1];
-                                prev_player_under[j] = prev_player_under[j + 1];
-                            }
-                            game_state.num_players--;
-
-                            // Move enemy to player's position
-                            set_tile_and_draw(enemy_x, enemy_y, game_state.objects[i].under);
-                            enemy_x = new_x;
-                            enemy_y = new_y;
-                            game_state.objects[i].x = new_x;
-                            game_state.objects[i].y = new_y;
-                            game_state.objects[i].under = tile_under_player;  // Store what was under player
-                            set_tile_and_draw(new_x, new_y, TILE_ENEMY);
-
-                            // Check if all players are dead
-                            if (game_state.num_players == 0) {
-                                game_state.level_complete = 2;  // Level failed
-                                return;
-                            }
-
-                            // After killing a player, check again for more players
-                            keep_checking = 1;
-
-                            break;  // Stop moving this direction
+                    occupant = ctx->entity_at[new_cell];
+                    if (occupant != ENTITY_NONE && ctx->game_state.type[occupant] == TILE_PLAYER) {
+                        player_caught = 1;
+
+                        // Save what was under the player (not the player itself!)
+                        tile_under_player = ctx->game_state.under[occupant];
+
+                        // Remove the caught player (like disappearing in duplication)
+                        remove_entity(CTX_ARG occupant);
+
+                        // Move enemy to player's position
+                        move_entity(CTX_ARG i, new_cell, tile_under_player);
+                        enemy_cell = new_cell;
+
+                        // Check if all players are dead
+                        if (ctx->game_state.num_players == 0) {
+                            ctx->game_state.level_complete = 2;  // Level failed
+                            compact_entities(CTX_ONLY);
+                            return;
                         }
+
+                        // After killing a player, check again for more players
+                        keep_checking = 1;
                     }
 
                     if (player_caught) {
@@ -831,69 +933,50 @@ void move_enemies(void) {
                     }
 
                     // enemystopper = crate or key or enemy or walls or door or gateA_closed or gateB_closed
-                    // Check if blocked by enemystopper
-                    if (!is_passable(new_tile) || new_tile == TILE_CRATE || new_tile == TILE_KEY ||
-                        new_tile == TILE_ENEMY || new_tile == TILE_DOOR ||
-                        new_tile == TILE_GATE_A || new_tile == TILE_GATE_B) {
+                    // Check if blocked by enemystopper (the map border is walled)
+                    if (is_enemy_stopper(new_tile)) {
                         break;  // Blocked, stop moving
                     }
 
                     // Move enemy one step
-                    set_tile_and_draw(enemy_x, enemy_y, game_state.objects[i].under);
-                    enemy_x = new_x;
-                    enemy_y = new_y;
-                    game_state.objects[i].x = new_x;
-                    game_state.objects[i].y = new_y;
-                    game_state.objects[i].under = new_tile;
-                    set_tile_and_draw(new_x, new_y, TILE_ENEMY);
+                    move_entity(CTX_ARG i, new_cell, new_tile);
+                    enemy_cell = new_cell;
                 }
             }
         }
         // If no line-of-sight, enemy doesn't move
     }
+
+    // Reclaim the slots of caught players
+    compact_entities(CTX_ONLY);
 }
 
 /*
   Try to push an object at a position in a direction
   Handles chain pushing by checking the entire chain first
 */
-byte try_push(byte x, byte y, signed char dx, signed char dy) {
+byte try_push(CTX_PARAM byte cell, byte step) {
     byte i, j;
-    byte check_x, check_y;
+    byte last = cell;  // Last object in the chain
+    byte end;          // First free cell past the chain
     byte chain_length = 0;
-    byte end_x, end_y;
-    char check_tile;
     char end_tile;
-    char tile_under_key;
 
     // Find the length of the chain
-    // Start at the first object and walk forward
-    check_x = x;
-    check_y = y;
-
-    while (chain_length < 10) {  // Max chain length of 10
-        byte next_x = check_x + dx;
-        byte next_y = check_y + dy;
-
-        // Check bounds
-        if (next_x >= MAX_LEVEL_WIDTH || next_y >= MAX_LEVEL_HEIGHT) {
-            return 0;  // Can't push out of bounds
-        }
-
-        check_tile = get_tile(next_x, next_y);
+    // Start at the first object and walk forward; the border sentinel
+    // walls guarantee the walk stops inside the map
+    while (1) {
+        end = last + step;
+        end_tile = ctx->level_map[end];
+        ENGINE_COUNT(cells_scanned);
 
         // If the next tile is pushable, it's part of the chain
-        if (is_pushable(check_tile)) {
+        if (is_pushable(end_tile)) {
             chain_length++;
-            check_x = next_x;
-            check_y = next_y;
+            last = end;
         }
         // If the next tile is passable or a door, we found the end
-        else if (is_passable(check_tile) || check_tile == TILE_DOOR) {
-            // Found the end of the chain
-            end_x = next_x;
-            end_y = next_y;
-            end_tile = check_tile;
+        else if (is_passable(end_tile) || end_tile == TILE_DOOR) {
             break;
         }
         // Otherwise, blocked
@@ -904,116 +987,422 @@ byte try_push(byte x, byte y, signed char dx, signed char dy) {
 
     // Special case: If the END of the chain is hitting a door with a key
     if (end_tile == TILE_DOOR) {
-        // Find the last object in the chain (the one that will hit the door)
-        byte last_obj_x = x + dx * chain_length;
-        byte last_obj_y = y + dy * chain_length;
-        char last_obj_tile = get_tile(last_obj_x, last_obj_y);
-
-        if (last_obj_tile == TILE_KEY) {
-            // Remove the key that's hitting the door
-            // Use background_map to get the correct tile under the key
-            tile_under_key = background_map[last_obj_y][last_obj_x];
-
-            for (i = 0; i < game_state.num_objects; i++) {
-                if (game_state.objects[i].x == last_obj_x && game_state.objects[i].y == last_obj_y) {
-                    // Remove this object by shifting BOTH arrays
-                    for (j = i; j < game_state.num_objects - 1; j++) {
-                        game_state.objects[j] = game_state.objects[j + 1];
-                        prev_object_under[j] = prev_object_under[j + 1];
-                    }
-                    game_state.num_objects--;
-                    break;
-                }
-            }
+        // Only a key can open the door it hits
+        if (ctx->level_map[last] != TILE_KEY) {
+            return 0;
+        }
 
-            // Open the door and restore the tile that was under the key
-            handle_key_door(last_obj_x, last_obj_y, end_x, end_y, tile_under_key);
-
-            // Now push the remaining objects in the chain (if any)
-            if (chain_length > 0) {
-                for (i = chain_length - 1; i < 255; i--) {  // Count down (byte wraps at 0)
-                    byte obj_x = x + dx * i;
-                    byte obj_y = y + dy * i;
-                    byte new_x = obj_x + dx;
-                    byte new_y = obj_y + dy;
-
-                    // Find the object at this position and move it
-                    for (j = 0; j < game_state.num_objects; j++) {
-                        if (game_state.objects[j].x == obj_x && game_state.objects[j].y == obj_y) {
-                            char tile_to_restore = game_state.objects[j].under;
-                            char obj_type = game_state.objects[j].type;
-                            char new_under = get_tile(new_x, new_y);
-
-                            // Update object position
-                            game_state.objects[j].x = new_x;
-                            game_state.objects[j].y = new_y;
-                            game_state.objects[j].under = new_under;
-
-                            // Update map
-                            set_tile_and_draw(obj_x, obj_y, tile_to_restore);
-                            set_tile_and_draw(new_x, new_y, obj_type);
-                            break;
-                        }
-                    }
+        // Remove the key that's hitting the door
+        j = ctx->entity_at[last];
+        if (j != ENTITY_NONE) {
+            remove_entity(CTX_ARG j);
+        }
 
-                    if (i == 0) break;  // Prevent underflow
-                }
+        // Open the door and restore the tile that was under the key
+        // (use ctx->background_map to get the correct tile under the key)
+        handle_key_door(CTX_ARG last, end, ctx->background_map[last]);
+
+        // The remaining objects in the chain (if any) move into the key's cell
+        end = last;
+        last -= step;
+    } else {
+        chain_length++;  // Every object in the chain moves
+    }
+
+    // Push the objects from back to front
+    for (i = 0; i < chain_length; i++) {
+        // Look up the object at this position and move it
+        j = ctx->entity_at[last];
+        if (j != ENTITY_NONE) {
+            move_entity(CTX_ARG j, end, ctx->level_map[end]);
+        }
+        end = last;
+        last -= step;
+    }
+
+    return 1;  // Push successful
+}
+
+#ifdef ENGINE_UNDO
+// Undo timeline records. Each is [length][header][payload][length], so
+// the ring can be walked both ways. The header holds the move (in
+// dir_steps order), the record kind and, for turns, how many turns into
+// the keyframe span the turn is. Payloads:
+// - UNDO_DELTA: entity count, level_complete and flags before the turn,
+//   the number of changed cells, (cell, old tile) for each, then
+//   (slot, cell, type, under, prev_under) for each entity slot that changed
+// - UNDO_MOVE: nothing; the turn is replayed from the keyframe
+// - UNDO_KEYFRAME: entity count, level_complete, flags, the entity
+//   table, one bit per door (still closed) and one per gate (open)
+#define UNDO_MASK     (UNDO_RING_SIZE - 1)
+#define UNDO_AT(pos)  (ctx->undo_ring[(pos) & UNDO_MASK])
+#define UNDO_HEADER(start) UNDO_AT((start) + 1)
+
+#define UNDO_DELTA    0x00
+#define UNDO_MOVE     0x04
+#define UNDO_KEYFRAME 0x08
+#define UNDO_KIND     0x0C
+
+// Direction of each move code
+static const signed char undo_dx[4] = { 0, 0, -1, 1 };
+static const signed char undo_dy[4] = { -1, 1, 0, 0 };
+
+static word record_start(CTX_PARAM word end) {
+    return (end - UNDO_AT(end - 1)) & UNDO_MASK;
+}
+
+static word record_end(CTX_PARAM word start) {
+    return (start + UNDO_AT(start)) & UNDO_MASK;
+}
+
+// First turn record at or after pos (or undo_head)
+static word skip_keyframes(CTX_PARAM word pos) {
+    while (pos != ctx->undo_head && (UNDO_HEADER(pos) & UNDO_KIND) == UNDO_KEYFRAME) {
+        pos = record_end(CTX_ARG pos);
+    }
+    return pos;
+}
+
+static void put_undo_byte(CTX_PARAM byte value) {
+    ctx->undo_ring[ctx->undo_head] = value;
+    ctx->undo_head = (ctx->undo_head + 1) & UNDO_MASK;
+}
+
+// Drop the oldest keyframe and its turns until size more bytes fit
+static byte make_undo_room(CTX_PARAM word size) {
+    word pos;
+
+    while (UNDO_RING_SIZE - 1 - ((ctx->undo_head - ctx->undo_tail) & UNDO_MASK) < size) {
+        if (ctx->undo_tail == ctx->undo_head) {
+            return 0;  // Larger than the whole ring
+        }
+        pos = record_end(CTX_ARG ctx->undo_tail);
+        while (pos != ctx->undo_head && (UNDO_HEADER(pos) & UNDO_KIND) != UNDO_KEYFRAME) {
+            pos = record_end(CTX_ARG pos);
+        }
+        ctx->undo_tail = pos;
+    }
+    return 1;
+}
+
+static byte move_code(byte step) {
+    byte move = 0;
+
+    while (dir_steps[move] != step) {
+        move++;
+    }
+    return move;
+}
+
+static byte undo_flags(CTX_VOID) {
+    return ctx->gateA_open | (ctx->gateB_open << 1) | (ctx->gates_dirty << 2)
+        | (ctx->prev_holeA_occupied << 3) | (ctx->prev_holeB_occupied << 4);
+}
+
+static void restore_undo_flags(CTX_PARAM byte flags) {
+    ctx->gateA_open = flags & 1;
+    ctx->gateB_open = (flags >> 1) & 1;
+    ctx->gates_dirty = (flags >> 2) & 1;
+    ctx->prev_holeA_occupied = (flags >> 3) & 1;
+    ctx->prev_holeB_occupied = (flags >> 4) & 1;
+}
+
+// Called as a turn starts: a turn that replays the next undone one just
+// steps over it, any other is recorded
+static void begin_undo_turn(CTX_PARAM byte step) {
+    byte i, cell;
+    char tile;
+    word pos;
+
+    if (ctx->undo_replaying) {
+        return;
+    }
+
+    ctx->undo_redoing = 0;
+    if (ctx->undo_cursor != ctx->undo_head) {
+        pos = skip_keyframes(CTX_ARG ctx->undo_cursor);
+        if (pos != ctx->undo_head && (UNDO_HEADER(pos) & 3) == move_code(step)) {
+            ctx->undo_redoing = 1;
+            return;
+        }
+    }
+
+    ctx->undo_before = ctx->game_state;
+    ctx->undo_before_flags = undo_flags(CTX_ONLY);
+    memset(ctx->undo_bits, 0, sizeof(ctx->undo_bits));
+    ctx->undo_num_cells = 0;
+    ctx->undo_overflow = 0;
+    ctx->undo_recording = 1;
+
+    // A keyframe is due: note which doors are closed and gates open
+    // (under the entity covering a gate, if any)
+    if (ctx->undo_span >= UNDO_KEYFRAME_INTERVAL) {
+        memset(ctx->undo_door_bits, 0, sizeof(ctx->undo_door_bits));
+        for (i = 0; i < ctx->num_doors; i++) {
+            if (ctx->level_map[ctx->door_cells[i]] == TILE_DOOR) {
+                ctx->undo_door_bits[i >> 3] |= dirty_bit[i & 7];
             }
+        }
+        ctx->undo_gate_bits = 0;
+        for (i = 0; i < ctx->num_gates; i++) {
+            cell = ctx->gate_cells[i];
+            tile = ctx->entity_at[cell] == ENTITY_NONE
+                ? ctx->level_map[cell] : ctx->game_state.under[ctx->entity_at[cell]];
+            if (tile == 'G' || tile == 'H') {
+                ctx->undo_gate_bits |= dirty_bit[i];
+            }
+        }
+    }
+}
+
+// Write the entity table of the turn's start (keyframes) or the slots
+// that changed since (deltas)
+static void put_undo_slot(CTX_PARAM byte slot) {
+    put_undo_byte(CTX_ARG ctx->undo_before.cell[slot]);
+    put_undo_byte(CTX_ARG ctx->undo_before.type[slot]);
+    put_undo_byte(CTX_ARG ctx->undo_before.under[slot]);
+    put_undo_byte(CTX_ARG ctx->undo_before.prev_under[slot]);
+}
+
+static void put_undo_start(CTX_VOID) {
+    put_undo_byte(CTX_ARG ctx->undo_before.num_entities);
+    put_undo_byte(CTX_ARG ctx->undo_before.level_complete);
+    put_undo_byte(CTX_ARG ctx->undo_before_flags);
+}
+
+// Called when a recorded turn is over
+static void end_undo_turn(CTX_PARAM byte step, byte moved) {
+    byte changed[MAX_ENTITIES];
+    byte num_changed = 0;
+    byte keyframe, i, length;
+    word keyframe_length = 0;
+    word pos;
+    GameState* before = &ctx->undo_before;
+
+    if (ctx->undo_replaying) {
+        return;
+    }
+    if (ctx->undo_redoing) {
+        // Step over the redone turn (and the keyframe before it)
+        ctx->undo_redoing = 0;
+        pos = skip_keyframes(CTX_ARG ctx->undo_cursor);
+        ctx->undo_span = UNDO_HEADER(pos) >> 4;
+        ctx->undo_cursor = record_end(CTX_ARG pos);
+        return;
+    }
+    ctx->undo_recording = 0;
+    if (!moved) {
+        return;  // Nothing changed (undone turns stay redoable)
+    }
+    ctx->undo_head = ctx->undo_cursor;  // A new turn: the undone ones are gone
+
+    // Entity slots that held something else before the turn
+    for (i = 0; i < before->num_entities; i++) {
+        if (i >= ctx->game_state.num_entities
+                || before->cell[i] != ctx->game_state.cell[i]
+                || before->type[i] != ctx->game_state.type[i]
+                || before->under[i] != ctx->game_state.under[i]
+                || before->prev_under[i] != ctx->game_state.prev_under[i]) {
+            changed[num_changed++] = i;
+        }
+    }
+
+    length = ctx->undo_overflow ? 3 : 7 + 2 * ctx->undo_num_cells + 5 * num_changed;
+    keyframe = ctx->undo_span >= UNDO_KEYFRAME_INTERVAL;
+    if (keyframe) {
+        keyframe_length = 7 + 4 * before->num_entities + ((ctx->num_doors + 7) >> 3);
+    }
+    if (!make_undo_room(CTX_ARG length + keyframe_length)
+            || (!keyframe && ctx->undo_tail == ctx->undo_head)) {
+        // No room even without the oldest span, or the span this turn
+        // belongs to was dropped: start over with the next turn
+        clear_undo(CTX_ONLY);
+        return;
+    }
+
+    if (keyframe) {
+        put_undo_byte(CTX_ARG (byte)keyframe_length);
+        put_undo_byte(CTX_ARG UNDO_KEYFRAME);
+        put_undo_start(CTX_ONLY);
+        for (i = 0; i < before->num_entities; i++) {
+            put_undo_slot(CTX_ARG i);
+        }
+        for (i = 0; i < ctx->num_doors; i += 8) {
+            put_undo_byte(CTX_ARG ctx->undo_door_bits[i >> 3]);
+        }
+        put_undo_byte(CTX_ARG ctx->undo_gate_bits);
+        put_undo_byte(CTX_ARG (byte)keyframe_length);
+        ctx->undo_span = 0;
+    }
+
+    ctx->undo_span++;
+    put_undo_byte(CTX_ARG length);
+    put_undo_byte(CTX_ARG move_code(step) | (ctx->undo_overflow ? UNDO_MOVE : UNDO_DELTA)
+                  | (ctx->undo_span << 4));
+    if (!ctx->undo_overflow) {
+        put_undo_start(CTX_ONLY);
+        put_undo_byte(CTX_ARG ctx->undo_num_cells);
+        for (i = 0; i < ctx->undo_num_cells; i++) {
+            put_undo_byte(CTX_ARG ctx->undo_cells[i]);
+            put_undo_byte(CTX_ARG ctx->undo_tiles[i]);
+        }
+        for (i = 0; i < num_changed; i++) {
+            put_undo_byte(CTX_ARG changed[i]);
+            put_undo_slot(CTX_ARG changed[i]);
+        }
+    }
+    put_undo_byte(CTX_ARG length);
+    ctx->undo_cursor = ctx->undo_head;
+}
 
-            return 1;
+// Re-derive what follows from a restored entity table: the kind counts,
+// the occupancy index and the plate counters
+static void finish_undo(CTX_VOID) {
+    byte i;
+
+    ctx->game_state.num_players = 0;
+    ctx->game_state.num_objects = 0;
+    ctx->plateA_count = 0;
+    ctx->plateB_count = 0;
+    for (i = 0; i < ctx->game_state.num_entities; i++) {
+        ctx->entity_at[ctx->game_state.cell[i]] = i;
+        if (ctx->game_state.type[i] == TILE_PLAYER) {
+            ctx->game_state.num_players++;
         } else {
-            // Non-key object hitting door - can't push
-            return 0;
+            ctx->game_state.num_objects++;
         }
+        enter_tile(CTX_ARG ctx->game_state.under[i]);
     }
+}
 
-    // Normal push (no door involved) - push all objects from back to front
-    for (i = chain_length; i < 255; i--) {  // Count down (byte wraps at 0)
-        byte obj_x = x + dx * i;
-        byte obj_y = y + dy * i;
-        byte new_x = obj_x + dx;
-        byte new_y = obj_y + dy;
-
-        // Find the object at this position and move it
-        for (j = 0; j < game_state.num_objects; j++) {
-            if (game_state.objects[j].x == obj_x && game_state.objects[j].y == obj_y) {
-                char tile_to_restore = game_state.objects[j].under;
-                char obj_type = game_state.objects[j].type;
-                char new_under = get_tile(new_x, new_y);
-
-                // Update object position
-                game_state.objects[j].x = new_x;
-                game_state.objects[j].y = new_y;
-                game_state.objects[j].under = new_under;
-
-                // Update map
-                set_tile_and_draw(obj_x, obj_y, tile_to_restore);
-                set_tile_and_draw(new_x, new_y, obj_type);
-                break;
-            }
+// Read the entity count, level_complete and flags; returns the next position
+static word read_undo_start(CTX_PARAM word pos) {
+    byte i;
+
+    // The entities are about to move back: take them off the index
+    for (i = 0; i < ctx->game_state.num_entities; i++) {
+        ctx->entity_at[ctx->game_state.cell[i]] = ENTITY_NONE;
+    }
+    ctx->game_state.num_entities = UNDO_AT(pos);
+    ctx->game_state.level_complete = UNDO_AT(pos + 1);
+    restore_undo_flags(CTX_ARG UNDO_AT(pos + 2));
+    return pos + 3;
+}
+
+static word read_undo_slot(CTX_PARAM word pos, byte slot) {
+    ctx->game_state.cell[slot] = UNDO_AT(pos);
+    ctx->game_state.type[slot] = UNDO_AT(pos + 1);
+    ctx->game_state.under[slot] = UNDO_AT(pos + 2);
+    ctx->game_state.prev_under[slot] = UNDO_AT(pos + 3);
+    return pos + 4;
+}
+
+// Take back a delta turn: only the cells and slots it changed
+static void apply_undo_delta(CTX_PARAM word start) {
+    word end = (record_end(CTX_ARG start) - 1) & UNDO_MASK;
+    word pos;
+    byte n;
+
+    pos = read_undo_start(CTX_ARG start + 2);
+    for (n = UNDO_AT(pos++); n > 0; n--) {
+        update_cell(CTX_ARG UNDO_AT(pos), UNDO_AT(pos + 1));
+        pos += 2;
+    }
+    while ((pos & UNDO_MASK) != end) {
+        pos = read_undo_slot(CTX_ARG pos + 1, UNDO_AT(pos));
+    }
+    finish_undo(CTX_ONLY);
+}
+
+// Put the board back to a keyframe, redrawing only the cells that differ
+static void restore_undo_keyframe(CTX_PARAM word start) {
+    byte i, cell, bits = 0;
+    char tile;
+    word pos;
+
+    // Uncover the cells under the entities
+    for (i = 0; i < ctx->game_state.num_entities; i++) {
+        update_cell(CTX_ARG ctx->game_state.cell[i], ctx->game_state.under[i]);
+    }
+
+    pos = read_undo_start(CTX_ARG start + 2);
+    for (i = 0; i < ctx->game_state.num_entities; i++) {
+        pos = read_undo_slot(CTX_ARG pos, i);
+    }
+
+    for (i = 0; i < ctx->num_doors; i++) {
+        if ((i & 7) == 0) {
+            bits = UNDO_AT(pos++);
         }
+        tile = (bits & 1) ? TILE_DOOR : TILE_FLOOR;
+        bits >>= 1;
+        cell = ctx->door_cells[i];
+        if (ctx->level_map[cell] != tile) {
+            update_cell(CTX_ARG cell, tile);
+        }
+    }
 
-        if (i == 0) break;  // Prevent underflow
+    bits = UNDO_AT(pos);
+    for (i = 0; i < ctx->num_gates; i++) {
+        cell = ctx->gate_cells[i];
+        tile = ctx->background_map[cell];
+        if (tile == TILE_GATE_A || tile == 'G') {
+            tile = (bits & 1) ? 'G' : TILE_GATE_A;
+        } else {
+            tile = (bits & 1) ? 'H' : TILE_GATE_B;
+        }
+        bits >>= 1;
+        if (ctx->level_map[cell] != tile) {
+            update_cell(CTX_ARG cell, tile);
+        }
     }
 
-    return 1;  // Push successful
+    for (i = 0; i < ctx->game_state.num_entities; i++) {
+        update_cell(CTX_ARG ctx->game_state.cell[i], ctx->game_state.type[i]);
+    }
+    finish_undo(CTX_ONLY);
 }
+#endif
 
  /*
   Try to move the player in the given direction
   New algorithm: Process players from back to front in movement direction
   This ensures that when multiple players are in a line, they all move together
 */
-byte try_move_player(signed char dx, signed char dy) {
-    byte i, j, new_x, new_y;
+byte try_move_player(CTX_PARAM signed char dx, signed char dy) {
+    byte i, j, new_cell;
+    byte step;
     char target_tile;
     byte moved = 0;
     byte player_order[MAX_PLAYERS];
+    byte num_order = 0;
     byte temp_idx;
 
-    /* Step 1: Create an array of player indices */
-    for (i = 0; i < game_state.num_players; i++) {
-        player_order[i] = i;
+    /* Convert the direction to a cell step */
+    if (dx == 1) {
+        step = STEP_RIGHT;
+    } else if (dx == -1) {
+        step = STEP_LEFT;
+    } else if (dy == 1) {
+        step = STEP_DOWN;
+    } else if (dy == -1) {
+        step = STEP_UP;
+    } else {
+        return 0;
+    }
+
+#ifdef ENGINE_UNDO
+    ENGINE_STAGE(STAGE_UNDO);
+    begin_undo_turn(CTX_ARG step);
+#endif
+    ENGINE_STAGE(STAGE_PLAYERS);
+
+    /* Step 1: Collect the entity table slots holding players */
+    for (i = 0; i < ctx->game_state.num_entities; i++) {
+        ENGINE_COUNT(entities_touched);
+        if (ctx->game_state.type[i] == TILE_PLAYER) {
+            player_order[num_order++] = i;
+        }
     }
 
     /* Step 2: Sort players so we process them from BACK to FRONT
@@ -1023,29 +1412,31 @@ byte try_move_player(signed char dx, signed char dy) {
        - If moving DOWN (dy=1), process bottom players first
        - If moving UP (dy=-1), process top players first
     */
-    for (i = 0; i < game_state.num_players - 1; i++) {
-        for (j = i + 1; j < game_state.num_players; j++) {
+    for (i = 0; i < num_order - 1; i++) {
+        for (j = i + 1; j < num_order; j++) {
             byte should_swap = 0;
+            byte cell_i = ctx->game_state.cell[player_order[i]];
+            byte cell_j = ctx->game_state.cell[player_order[j]];
 
             /* Determine if we should swap based on movement direction */
             if (dx == 1) {
                 /* Moving right: process rightmost first */
-                if (game_state.players[player_order[i]].x < game_state.players[player_order[j]].x) {
+                if (cell_x(cell_i) < cell_x(cell_j)) {
                     should_swap = 1;
                 }
             } else if (dx == -1) {
                 /* Moving left: process leftmost first */
-                if (game_state.players[player_order[i]].x > game_state.players[player_order[j]].x) {
+                if (cell_x(cell_i) > cell_x(cell_j)) {
                     should_swap = 1;
                 }
             } else if (dy == 1) {
                 /* Moving down: process bottom first */
-                if (game_state.players[player_order[i]].y < game_state.players[player_order[j]].y) {
+                if (cell_y(cell_i) < cell_y(cell_j)) {
                     should_swap = 1;
                 }
             } else if (dy == -1) {
                 /* Moving up: process top first */
-                if (game_state.players[player_order[i]].y > game_state.players[player_order[j]].y) {
+                if (cell_y(cell_i) > cell_y(cell_j)) {
                     should_swap = 1;
                 }
             }
@@ -1059,71 +1450,280 @@ byte try_move_player(signed char dx, signed char dy) {
     }
 
     /* Step 3: Process players in sorted order (back to front) */
-    for (i = 0; i < game_state.num_players; i++) {
+    for (i = 0; i < num_order; i++) {
         byte player_idx = player_order[i];
 
-        new_x = game_state.players[player_idx].x + dx;
-        new_y = game_state.players[player_idx].y + dy;
-
-        /* Check bounds */
-        if (new_x >= MAX_LEVEL_WIDTH || new_y >= MAX_LEVEL_HEIGHT) {
-            continue;
-        }
+        new_cell = ctx->game_state.cell[player_idx] + step;
+        target_tile = ctx->level_map[new_cell];
+        ENGINE_COUNT(cells_scanned);
 
-        target_tile = get_tile(new_x, new_y);
-
-        /* Check if target is passable */
+        /* Check if target is passable (the map border is walled) */
         if (is_passable(target_tile)) {
-            /* Restore tile under old position */
-            set_tile_and_draw(game_state.players[player_idx].x, game_state.players[player_idx].y, game_state.players[player_idx].under);
-
-            /* Move player */
-            game_state.players[player_idx].x = new_x;
-            game_state.players[player_idx].y = new_y;
-            game_state.players[player_idx].under = target_tile;
+            /* Move player, restoring the tile under the old position */
+            move_entity(CTX_ARG player_idx, new_cell, target_tile);
 
             /* Check if reached exit */
             if (is_exit(target_tile)) {
-                game_state.level_complete = 1;
+                ctx->game_state.level_complete = 1;
             }
-
-            /* Set player at new position */
-            set_tile_and_draw(new_x, new_y, TILE_PLAYER);
             moved = 1;
         }
         /* Check if target is pushable */
         else if (is_pushable(target_tile)) {
-            if (try_push(new_x, new_y, dx, dy)) {
-                /* Restore tile under old position */
-                set_tile_and_draw(game_state.players[player_idx].x, game_state.players[player_idx].y, game_state.players[player_idx].under);
-
-                /* Move player */
-                game_state.players[player_idx].x = new_x;
-                game_state.players[player_idx].y = new_y;
-
+            if (try_push(CTX_ARG new_cell, step)) {
                 /* Re-read the tile to correctly update the player's 'under' memory */
-                game_state.players[player_idx].under = get_tile(new_x, new_y);
-
-                set_tile_and_draw(new_x, new_y, TILE_PLAYER);
+                move_entity(CTX_ARG player_idx, new_cell, ctx->level_map[new_cell]);
                 moved = 1;
             }
         }
     }
 
+    /* Reclaim the slots of keys consumed by doors */
+    compact_entities(CTX_ONLY);
+
     if (moved) {
-        handle_duplication();
-        update_gates();
-        move_enemies();  // Move enemies after player moves
+        ENGINE_STAGE(STAGE_DUPLICATION);
+        handle_duplication(CTX_ONLY);
+        ENGINE_STAGE(STAGE_GATES);
+        update_gates(CTX_ONLY);
+        ENGINE_STAGE(STAGE_ENEMIES);
+        move_enemies(CTX_ONLY);  // Move enemies after player moves
     }
 
+#ifdef ENGINE_UNDO
+    ENGINE_STAGE(STAGE_UNDO);
+    end_undo_turn(CTX_ARG step, moved);
+#endif
+    ENGINE_STAGE(STAGE_END);
     return moved;
 }
 
+#ifdef ENGINE_UNDO
+// Undo a turn recorded as a move alone: go back to the keyframe of its
+// span and replay the turns before it
+static void replay_from_keyframe(CTX_PARAM word start) {
+    word pos = start;
+    byte move;
+
+    do {
+        pos = record_start(CTX_ARG pos);
+    } while ((UNDO_HEADER(pos) & UNDO_KIND) != UNDO_KEYFRAME);
+    restore_undo_keyframe(CTX_ARG pos);
+
+    ctx->undo_replaying = 1;
+    for (pos = record_end(CTX_ARG pos); pos != start; pos = record_end(CTX_ARG pos)) {
+        move = UNDO_HEADER(pos) & 3;
+        try_move_player(CTX_ARG undo_dx[move], undo_dy[move]);
+    }
+    ctx->undo_replaying = 0;
+}
+
+byte undo_turn(CTX_VOID) {
+    word pos = ctx->undo_cursor;
+    word start;
+
+    // Step back over keyframes to the last turn
+    while (pos != ctx->undo_tail) {
+        start = record_start(CTX_ARG pos);
+        if ((UNDO_HEADER(start) & UNDO_KIND) != UNDO_KEYFRAME) {
+            break;
+        }
+        pos = start;
+    }
+    if (pos == ctx->undo_tail) {
+        return 0;
+    }
+
+    start = record_start(CTX_ARG pos);
+    if ((UNDO_HEADER(start) & UNDO_KIND) == UNDO_DELTA) {
+        apply_undo_delta(CTX_ARG start);
+    } else {
+        replay_from_keyframe(CTX_ARG start);
+    }
+    ctx->undo_cursor = start;
+    ctx->undo_span = UNDO_HEADER(record_start(CTX_ARG start)) >> 4;
+    return 1;
+}
+
+byte redo_turn(CTX_VOID) {
+    word pos = skip_keyframes(CTX_ARG ctx->undo_cursor);
+    byte move;
+
+    if (pos == ctx->undo_head) {
+        return 0;
+    }
+    move = UNDO_HEADER(pos) & 3;
+    return try_move_player(CTX_ARG undo_dx[move], undo_dy[move]);
+}
+#endif
+
+byte is_level_complete(CTX_VOID) {
+    return ctx->game_state.level_complete;
+}
+
+GameState* get_game_state(CTX_VOID) {
+    return &ctx->game_state;
+}
+
+#ifdef ENGINE_COUNTERS
+EngineCounters* get_engine_counters(CTX_VOID) {
+    return &ctx->counters;
+}
+#endif
+
+#ifdef ENGINE_HASH
+state_hash get_state_hash(CTX_VOID) {
+    return ctx->hash;
+}
+#endif
+
+#ifdef ENGINE_REENTRANT
+// Plain API on a default context (what the Atari builds and tests call)
+#ifdef ENGINE_LEVEL_STRINGS
+#undef load_level
+#endif
+#ifdef ENGINE_LEVEL_PACKED
+#undef load_packed_level
+#endif
+#undef draw_level
+#undef restart_level
+#undef reset_duplication_tracking
+#undef try_move_player
+#undef is_level_complete
+#undef get_game_state
+#undef get_tile
+#undef get_entity_at
+#undef set_tile
+#undef try_push
+#undef door_flood_fill
+#undef remove_open_doors
+#undef handle_key_door
+#undef update_gates
+#undef handle_duplication
+#undef move_enemies
+#undef set_tile_and_draw
+#undef flush_dirty_cells
+#undef set_render_enabled
+#ifdef ENGINE_COUNTERS
+#undef get_engine_counters
+#endif
+#ifdef ENGINE_HASH
+#undef get_state_hash
+#endif
+#ifdef ENGINE_UNDO
+#undef undo_turn
+#undef redo_turn
+#endif
+
+static EngineContext default_context;
+
+#ifdef ENGINE_LEVEL_STRINGS
+void load_level(const char* level_data[], byte num_rows) {
+    engine_load_level(&default_context, level_data, num_rows);
+}
+#endif
+
+#ifdef ENGINE_LEVEL_PACKED
+void load_packed_level(const byte* data) {
+    engine_load_packed_level(&default_context, data);
+}
+#endif
+
+void draw_level(void) {
+    engine_draw_level(&default_context);
+}
+
+void restart_level(void) {
+    engine_restart_level(&default_context);
+}
+
+void reset_duplication_tracking(void) {
+    engine_reset_duplication_tracking(&default_context);
+}
+
+byte try_move_player(signed char dx, signed char dy) {
+    return engine_try_move_player(&default_context, dx, dy);
+}
+
 byte is_level_complete(void) {
-    return game_state.level_complete;
+    return engine_is_level_complete(&default_context);
 }
 
 GameState* get_game_state(void) {
-    return &game_state;
+    return engine_get_game_state(&default_context);
 }
 
+byte get_tile(byte x, byte y) {
+    return engine_get_tile(&default_context, x, y);
+}
+
+byte get_entity_at(byte x, byte y) {
+    return engine_get_entity_at(&default_context, x, y);
+}
+
+void set_tile(byte x, byte y, byte tile) {
+    engine_set_tile(&default_context, x, y, tile);
+}
+
+byte try_push(byte cell, byte step) {
+    return engine_try_push(&default_context, cell, step);
+}
+
+void door_flood_fill(byte cell) {
+    engine_door_flood_fill(&default_context, cell);
+}
+
+void remove_open_doors(void) {
+    engine_remove_open_doors(&default_context);
+}
+
+void handle_key_door(byte key_cell, byte door_cell, char tile_under_key) {
+    engine_handle_key_door(&default_context, key_cell, door_cell, tile_under_key);
+}
+
+void update_gates(void) {
+    engine_update_gates(&default_context);
+}
+
+void handle_duplication(void) {
+    engine_handle_duplication(&default_context);
+}
+
+void move_enemies(void) {
+    engine_move_enemies(&default_context);
+}
+
+void set_tile_and_draw(byte x, byte y, char tile) {
+    engine_set_tile_and_draw(&default_context, x, y, tile);
+}
+
+byte flush_dirty_cells(void) {
+    return engine_flush_dirty_cells(&default_context);
+}
+
+void set_render_enabled(byte enabled) {
+    engine_set_render_enabled(&default_context, enabled);
+}
+
+#ifdef ENGINE_COUNTERS
+EngineCounters* get_engine_counters(void) {
+    return engine_get_engine_counters(&default_context);
+}
+#endif
+
+#ifdef ENGINE_HASH
+state_hash get_state_hash(void) {
+    return engine_get_state_hash(&default_context);
+}
+#endif
+
+#ifdef ENGINE_UNDO
+byte undo_turn(void) {
+    return engine_undo_turn(&default_context);
+}
+
+byte redo_turn(void) {
+    return engine_redo_turn(&default_context);
+}
+#endif
+#endif
@@ -20,6 +20,21 @@ typedef unsigned short word;
 #define MAX_LEVEL_HEIGHT 11  // Exact height of levels
 #define SCREEN_TOP_MARGIN 2  // Number of lines reserved for title/UI at top
 
+// Linear cell indexing: the engine addresses the map with a single byte.
+// Each row has a sentinel column on its right and there is a sentinel row
+// above and below the level; sentinels always hold TILE_WALL, so stepping
+// to a neighbour never needs a bounds check.
+#define MAP_STRIDE (MAX_LEVEL_WIDTH + 1)
+#define MAP_ROWS   (MAX_LEVEL_HEIGHT + 2)
+#define MAP_CELLS  (MAP_STRIDE * MAP_ROWS)  // 247 cells
+#define CELL(x, y) ((byte)(((y) + 1) * MAP_STRIDE + (x)))
+
+// Cell steps for each direction (added to a cell index, wrapping in a byte)
+#define STEP_RIGHT ((byte)1)
+#define STEP_LEFT  ((byte)-1)
+#define STEP_DOWN  ((byte)MAP_STRIDE)
+#define STEP_UP    ((byte)-MAP_STRIDE)
+
 // Tile types
 #define TILE_EMPTY      ' '
 #define TILE_WALL       '#'
@@ -48,38 +63,55 @@ typedef unsigned short word;
 #define TILE_CAT_HOLE        0x10  // Duplication hole
 #define TILE_CAT_PLATE       0x20  // Pressure plate
 #define TILE_CAT_GATE        0x40  // Gate (open/closed)
+#define TILE_CAT_ENEMY_STOP  0x80  // Stops enemy movement and line-of-sight
 
 // Maximum players (optimized for memory)
 #define MAX_PLAYERS 6  // Allows up to 2 duplications (1->2->4, or 1->2->3->4->5->6)
 #define MAX_OBJECTS 8  // Max pushable objects (keys, crates, enemies)
 
-// Player structure (compact)
-typedef struct {
-    byte x;
-    byte y;
-    char under;  // What tile is underneath
-} Player;
+// Fixed-position tile registries (filled once per level by load_level)
+#define MAX_GATES  8   // Gate cells (open or closed)
+#define MAX_HOLES  4   // Duplication hole cells
+#define MAX_PLATES 4   // Pressure plate cells
+#define MAX_DOORS  16  // Door cells (level_15 has 14)
 
-// Pushable object structure (for keys, crates, enemies)
-typedef struct {
-    byte x;
-    byte y;
-    char type;   // 'k', '*', 'e'
-    char under;  // What tile is underneath
-} PushableObject;
+#define MAX_ENTITIES (MAX_PLAYERS + MAX_OBJECTS)  // Entity table capacity
 
-// Game state structure with multiple players
+#define FLOOD_QUEUE_SIZE 32  // Door flood fill queue
+#define DIRTY_QUEUE_SIZE 64  // Cells queued for redraw before a full redraw
+
+// Occupancy index encoding (see get_entity_at)
+#define ENTITY_NONE    0xFF  // No entity on the cell
+#define ENTITY_REMOVED 0     // Type of a slot freed during a turn (compacted at turn end)
+
+// Game state: one structure-of-arrays table holding players ('p') and
+// pushable objects ('k', '*', 'e'). Removing an entity keeps the order of
+// the remaining slots, and new entities are appended; the order matters,
+// as enemies chase the first player they see in slot order.
 typedef struct {
-    Player players[MAX_PLAYERS];
-    byte num_players;
-    PushableObject objects[MAX_OBJECTS];
-    byte num_objects;
+    byte cell[MAX_ENTITIES];        // Position (see CELL, cell_x, cell_y)
+    char type[MAX_ENTITIES];        // TILE_PLAYER, TILE_KEY, TILE_CRATE or TILE_ENEMY
+    char under[MAX_ENTITIES];       // What tile is underneath
+    char prev_under[MAX_ENTITIES];  // 'under' after the previous turn (duplication tracking)
+    byte num_entities;
+    byte num_players;               // Entities with type TILE_PLAYER
+    byte num_objects;               // All other entities
     byte level_width;
     byte level_height;
     byte level_complete;
     byte current_level;
 } GameState;
 
+/*
+  Level loaders, each behind its own flag: ENGINE_LEVEL_STRINGS builds
+  load_level and ENGINE_LEVEL_PACKED builds load_packed_level. With
+  neither defined, the game gets only the string loader it uses.
+*/
+#if !defined(ENGINE_LEVEL_STRINGS) && !defined(ENGINE_LEVEL_PACKED)
+#define ENGINE_LEVEL_STRINGS
+#endif
+
+#ifdef ENGINE_LEVEL_STRINGS
 /*
   Load a level from string array
   
@@ -87,15 +119,37 @@ typedef struct {
   @param num_rows - Number of rows in the level
 */
 void load_level(const char* level_data[], byte num_rows);
+#endif
+
+#ifdef ENGINE_LEVEL_PACKED
+/*
+  Load a level from packed data (see test/level_compiler.c)
+  Streams the data straight into the maps; the result is the same as
+  load_level on the rows the data was compiled from
+
+  @param data - Width, height, wall/floor runs (a nibble each), then a
+                count and that many (cell, tile) pairs for every other tile
+*/
+void load_packed_level(const byte* data);
+#endif
 
 /*
   Draw the entire level to screen
 */
 void draw_level(void);
 
+/*
+  Put the level back the way load_level left it, without reparsing
+  Copies the starting position kept by load_level and queues only the
+  cells that differ from it for redraw (see flush_dirty_cells). Keeps
+  current_level; clears the undo timeline.
+*/
+void restart_level(void);
+
 /*
   Reset duplication tracking
-  Call this after manually modifying player/object positions
+  Call this after manually modifying the entity table
+  (also rebuilds the per-cell occupancy index)
 */
 void reset_duplication_tracking(void);
 
@@ -131,6 +185,15 @@ GameState* get_game_state(void);
 */
 byte get_tile(byte x, byte y);
 
+/*
+  Get the entity standing at a specific position
+
+  @param x - X coordinate
+  @param y - Y coordinate
+  @return Entity table slot, or ENTITY_NONE if the cell is empty
+*/
+byte get_entity_at(byte x, byte y);
+
 /*
   Set the tile at a specific position
 
@@ -157,10 +220,27 @@ byte is_blocking(char tile);
 byte is_passable(char tile);
 
 /*
-  Tile category lookup table - external declaration
+  Cell to column/row lookup tables - external declaration
   Defined in duplicator_game.c
 */
-extern byte tile_categories[256];
+extern const byte map_cell_x[MAP_CELLS];
+extern const byte map_cell_y[MAP_CELLS];
+
+/*
+  Get the column of a cell - INLINE MACRO using lookup table
+*/
+#define cell_x(cell) (map_cell_x[(byte)(cell)])
+
+/*
+  Get the level row of a cell - INLINE MACRO using lookup table
+*/
+#define cell_y(cell) (map_cell_y[(byte)(cell)])
+
+/*
+  Tile category lookup table - external declaration
+  Generated into duplicator_tile_props.h by tools/gen_tile_tables.js
+*/
+extern const byte tile_categories[256];
 
 /*
   Check if a tile is an exit - INLINE MACRO using category table
@@ -187,24 +267,26 @@ extern byte tile_categories[256];
 */
 #define is_gate(tile) ((tile_categories[(byte)(tile)] & TILE_CAT_GATE) != 0)
 
+/*
+  Check if a tile stops an enemy (movement and line-of-sight) - INLINE MACRO using category table
+*/
+#define is_enemy_stopper(tile) ((tile_categories[(byte)(tile)] & TILE_CAT_ENEMY_STOP) != 0)
+
 /*
   Try to push an object at a position in a direction
 
-  @param x - X coordinate of object to push
-  @param y - Y coordinate of object to push
-  @param dx - Horizontal push direction (-1, 0, or 1)
-  @param dy - Vertical push direction (-1, 0, or 1)
+  @param cell - Cell of object to push
+  @param step - Push direction (STEP_RIGHT, STEP_LEFT, STEP_DOWN or STEP_UP)
   @return 1 if push was successful, 0 otherwise
 */
-byte try_push(byte x, byte y, signed char dx, signed char dy);
+byte try_push(byte cell, byte step);
 
 /*
   Flood fill to spread door_open state to adjacent doors
 
-  @param x - X coordinate of starting door
-  @param y - Y coordinate of starting door
+  @param cell - Cell of starting door
 */
-void door_flood_fill(byte x, byte y);
+void door_flood_fill(byte cell);
 
 /*
   Remove all open doors (door_) from the level
@@ -214,13 +296,11 @@ void remove_open_doors(void);
 /*
   Handle key touching door interaction
 
-  @param key_x - X coordinate of key
-  @param key_y - Y coordinate of key
-  @param door_x - X coordinate of door
-  @param door_y - Y coordinate of door
+  @param key_cell - Cell of key
+  @param door_cell - Cell of door
   @param tile_under_key - The tile that was under the key (to restore it)
 */
-void handle_key_door(byte key_x, byte key_y, byte door_x, byte door_y, char tile_under_key);
+void handle_key_door(byte key_cell, byte door_cell, char tile_under_key);
 
 /*
   Update gate states based on plate activation
@@ -230,6 +310,10 @@ void handle_key_door(byte key_x, byte key_y, byte door_x, byte door_y, char tile
   - plateA without object -> gateA closes
   - plateB with object -> gateB opens
   - plateB without object -> gateB closes
+
+  Plate occupancy is kept in counters updated as entities move, so
+  this returns immediately unless a counter crossed zero since the
+  last call (or an entity uncovered a gate while it was switching).
 */
 void update_gates(void);
 
@@ -253,10 +337,10 @@ void handle_duplication(void);
 void move_enemies(void);
 
 /*
-  Set tile in both level map and screen display
+  Set tile in the level map and queue it for redraw
 
-  Helper function that combines set_tile() and my_cputcxy() to update
-  both the game state and screen display in one call.
+  The screen is not touched until flush_dirty_cells(), so a cell that
+  changes several times in one turn is drawn once, with its final tile.
 
   @param x - X coordinate
   @param y - Y coordinate
@@ -264,5 +348,291 @@ void move_enemies(void);
 */
 void set_tile_and_draw(byte x, byte y, char tile);
 
+/*
+  Draw every cell changed since the last flush (or draw_level)
+
+  Call right after wait_vblank so a whole turn appears at once.
+  Redraws the full level if more cells changed than the queue holds.
+
+  @return Number of cells that were queued
+*/
+byte flush_dirty_cells(void);
+
+/*
+  Turn screen updates on or off (on after startup)
+
+  With rendering off the engine only updates the level map and entity
+  table: no cell is queued and flush_dirty_cells draws nothing, so
+  solvers and replays simulate at full speed. The screen is not brought
+  up to date when rendering is turned back on; call draw_level for that.
+
+  @param enabled - 1 to queue changes for drawing, 0 for headless simulation
+*/
+void set_render_enabled(byte enabled);
+
+/*
+  Engine stage hook for the cycle benchmark (test/duplicator_bench.c)
+  and the on-device frame HUD (duplicator_16x16.c built with FRAME_HUD)
+
+  Built with ENGINE_PROFILE defined, try_move_player calls engine_stage()
+  as each stage starts and with STAGE_END when the turn is done; the
+  first call of a turn follows a STAGE_END. The benchmark or HUD provides
+  engine_stage(). Otherwise the hook compiles away.
+*/
+#if defined(FRAME_HUD) && !defined(ENGINE_PROFILE)
+#define ENGINE_PROFILE
+#endif
+
+#define STAGE_UNDO        0  // Undo recording (ENGINE_UNDO), before and after the moves
+#define STAGE_PLAYERS     1  // Sort, move and push players
+#define STAGE_DUPLICATION 2  // handle_duplication
+#define STAGE_GATES       3  // update_gates
+#define STAGE_ENEMIES     4  // move_enemies
+#define STAGE_END         5  // Number of stages / turn finished
+
+#ifdef ENGINE_PROFILE
+void engine_stage(byte stage);
+#define ENGINE_STAGE(stage) engine_stage(stage)
+#else
+#define ENGINE_STAGE(stage)
+#endif
+
+/*
+  Work counters for the worst-turn explorer (test/duplicator_explorer.c)
+
+  Built with ENGINE_COUNTERS defined, the engine counts the work it does
+  in the counters returned by get_engine_counters(); the caller clears
+  them before a turn. Otherwise ENGINE_COUNT compiles away.
+*/
+#ifdef ENGINE_COUNTERS
+typedef struct {
+    word cells_scanned;     // Map cells read by searches (pushes, sight lines, doors, registries)
+    word entities_touched;  // Entity table slots visited, moved, added or removed
+    word tiles_drawn;       // Cells drawn by draw_level or flush_dirty_cells
+} EngineCounters;
+
+#define ENGINE_COUNT(counter) (ctx->counters.counter++)
+#else
+#define ENGINE_COUNT(counter)
+#endif
+
+/*
+  Incremental board hash for solvers, repetition checks and trace
+  comparison
+
+  Built with ENGINE_HASH defined, the engine keeps a Zobrist hash of the
+  level map (every entity, door and gate) and updates it at each cell
+  change, so get_state_hash() is free. It is 64 bits on the host and 32
+  bits on the 6502. Entity table order and the duplication bookkeeping
+  (prev_under, hole and gate flags) are not part of the hash.
+*/
+#ifdef ENGINE_HASH
+#ifdef __CC65__
+typedef unsigned long state_hash;
+#else
+typedef unsigned long long state_hash;
+#endif
+#endif
+
+/*
+  Undo timeline
+
+  Built with ENGINE_UNDO, every turn that
+  moves something is recorded in a ring buffer of UNDO_RING_SIZE bytes
+  in the context: the old tile of each cell it changed, the entity table
+  slots that changed and the gate and hole flags. Every
+  UNDO_KEYFRAME_INTERVAL turns a keyframe stores the whole position the
+  way load_level left it plus the changes: the entity table, which doors
+  are still closed, which gates are open and the flags. A turn that
+  changes more than UNDO_MAX_CELLS cells keeps only its move; undoing it
+  goes back to the keyframe before it and replays the turns in between.
+  When the ring is full the oldest keyframe and its turns are dropped.
+  The ring and the per-turn buffers take well over 1 KB of RAM per
+  context, so the Atari games leave undo out unless every source is
+  built with -DENGINE_UNDO.
+*/
+
+#ifdef ENGINE_UNDO
+#ifndef UNDO_RING_SIZE
+#define UNDO_RING_SIZE 1024          // Bytes of history per context (a power of 2)
+#endif
+#ifndef UNDO_MAX_CELLS
+#define UNDO_MAX_CELLS 32            // Changed cells a turn record can hold
+#endif
+#ifndef UNDO_KEYFRAME_INTERVAL
+#define UNDO_KEYFRAME_INTERVAL 8     // Turns between keyframes (1-15)
+#endif
+#endif
+
+/*
+  Everything the engine knows about one game. The Atari builds keep a
+  single static context inside duplicator_game.c; host tools built with
+  ENGINE_REENTRANT can own as many as they like (see the engine_* API
+  below). A context starts zeroed (static, calloc or memset).
+*/
+typedef struct {
+    GameState game_state;
+    char level_map[MAP_CELLS];       // Tiles as shown (indexed by cell, see CELL)
+    char background_map[MAP_CELLS];  // Tiles under objects
+    byte entity_at[MAP_CELLS];       // Entity table slot on each cell (occupancy index)
+
+    // Starting position kept by load_level for restart_level
+    char pristine_map[MAP_CELLS];
+    GameState pristine_state;
+
+    // Fixed-position tiles recorded at load_level so per-move routines
+    // only visit these cells instead of scanning the whole map
+    byte gate_cells[MAX_GATES];
+    byte num_gates;
+    byte hole_cells[MAX_HOLES];
+    byte num_holes;
+    byte plate_cells[MAX_PLATES];
+    byte num_plates;
+    byte door_cells[MAX_DOORS];
+    byte num_doors;
+
+    // Door flood fill queue
+    byte flood_queue[FLOOD_QUEUE_SIZE];
+    byte queue_start;
+    byte queue_end;
+
+    // Cells changed since the last flush_dirty_cells(), each queued once
+    // (dirty_bits has one bit per cell to filter duplicates)
+    byte dirty_queue[DIRTY_QUEUE_SIZE];
+    byte num_dirty;
+    byte dirty_overflow;
+    byte dirty_bits[(MAP_CELLS + 7) / 8];
+    byte headless;                   // Set by set_render_enabled(0)
+
+    // Plate occupancy counters, adjusted whenever an entity's under tile changes
+    byte plateA_count;
+    byte plateB_count;
+
+    // Gate state last written to the map; gates_dirty is set when a gate
+    // tile restored from an entity's 'under' may no longer match that state
+    byte gateA_open;
+    byte gateB_open;
+    byte gates_dirty;
+
+    // Which holes held an entity after the previous turn (so nothing
+    // duplicates when objects move OUT of holes)
+    byte prev_holeA_occupied;
+    byte prev_holeB_occupied;
+
+#ifdef ENGINE_COUNTERS
+    EngineCounters counters;
+#endif
+#ifdef ENGINE_HASH
+    state_hash hash;                 // Hash of level_map (see get_state_hash)
+#endif
+#ifdef ENGINE_UNDO
+    // Undo timeline (see undo_turn): records from undo_tail to undo_head,
+    // those past undo_cursor are undone turns redo_turn can play again
+    byte undo_ring[UNDO_RING_SIZE];
+    word undo_tail;
+    word undo_cursor;
+    word undo_head;
+    byte undo_span;                  // Turns recorded since the last keyframe
+    byte undo_recording;             // The current turn's changes are being recorded
+    byte undo_redoing;               // The current turn replays the next undone turn
+    byte undo_replaying;             // Turns are being replayed from a keyframe
+
+    // The turn being recorded: the tile each changed cell had before it
+    // (each cell once, undo_bits filters repeats) and the entity table,
+    // flags, closed doors and open gates at its start
+    byte undo_cells[UNDO_MAX_CELLS];
+    char undo_tiles[UNDO_MAX_CELLS];
+    byte undo_num_cells;
+    byte undo_overflow;
+    byte undo_bits[(MAP_CELLS + 7) / 8];
+    GameState undo_before;
+    byte undo_before_flags;
+    byte undo_door_bits[(MAX_DOORS + 7) / 8];
+    byte undo_gate_bits;
+#endif
+} EngineContext;
+
+#ifdef ENGINE_COUNTERS
+/*
+  Get the work counters of the default context
+*/
+EngineCounters* get_engine_counters(void);
+#endif
+
+#ifdef ENGINE_HASH
+/*
+  Get the board hash of the default context
+  Recomputed from scratch by load_level and reset_duplication_tracking,
+  updated incrementally by every other change to the level map
+
+  @return Hash of the level map
+*/
+state_hash get_state_hash(void);
+#endif
+
+#ifdef ENGINE_UNDO
+/*
+  Take back the last turn of the default context
+  Restores only the cells the turn changed (and queues them for redraw);
+  a turn recorded as a move alone replays from the keyframe before it
+
+  @return 1 if a turn was undone, 0 if there is no earlier turn recorded
+*/
+byte undo_turn(void);
+
+/*
+  Play the last undone turn again
+  The same move given to try_move_player also redoes it; any other move
+  drops the undone turns. load_level, restart_level and
+  reset_duplication_tracking clear the timeline.
+
+  @return 1 if a turn was redone, 0 if there is nothing to redo
+*/
+byte redo_turn(void);
+#endif
+
+#ifdef ENGINE_REENTRANT
+/*
+  Reentrant API: the functions above working on a caller-owned context,
+  so several games can run in one process (one context per thread).
+  The plain functions use a default context.
+*/
+#ifdef ENGINE_LEVEL_STRINGS
+void engine_load_level(EngineContext* ctx, const char* level_data[], byte num_rows);
+#endif
+#ifdef ENGINE_LEVEL_PACKED
+void engine_load_packed_level(EngineContext* ctx, const byte* data);
+#endif
+void engine_draw_level(EngineContext* ctx);
+void engine_restart_level(EngineContext* ctx);
+void engine_reset_duplication_tracking(EngineContext* ctx);
+byte engine_try_move_player(EngineContext* ctx, signed char dx, signed char dy);
+byte engine_is_level_complete(EngineContext* ctx);
+GameState* engine_get_game_state(EngineContext* ctx);
+byte engine_get_tile(EngineContext* ctx, byte x, byte y);
+byte engine_get_entity_at(EngineContext* ctx, byte x, byte y);
+void engine_set_tile(EngineContext* ctx, byte x, byte y, byte tile);
+byte engine_try_push(EngineContext* ctx, byte cell, byte step);
+void engine_door_flood_fill(EngineContext* ctx, byte cell);
+void engine_remove_open_doors(EngineContext* ctx);
+void engine_handle_key_door(EngineContext* ctx, byte key_cell, byte door_cell, char tile_under_key);
+void engine_update_gates(EngineContext* ctx);
+void engine_handle_duplication(EngineContext* ctx);
+void engine_move_enemies(EngineContext* ctx);
+void engine_set_tile_and_draw(EngineContext* ctx, byte x, byte y, char tile);
+byte engine_flush_dirty_cells(EngineContext* ctx);
+void engine_set_render_enabled(EngineContext* ctx, byte enabled);
+#ifdef ENGINE_COUNTERS
+EngineCounters* engine_get_engine_counters(EngineContext* ctx);
+#endif
+#ifdef ENGINE_HASH
+state_hash engine_get_state_hash(EngineContext* ctx);
+#endif
+#ifdef ENGINE_UNDO
+byte engine_undo_turn(EngineContext* ctx);
+byte engine_redo_turn(EngineContext* ctx);
+#endif
+#endif
+
 #endif // DUPLICATOR_GAME_H
 
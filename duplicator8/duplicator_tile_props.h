@@ -0,0 +1,298 @@
+/* duplicator_tile_props.h - Tile property tables
+ *
+ * GENERATED by tools/gen_tile_tables.js from duplicator_tiles_16x16.h
+ * and duplicator_game.h - do not edit by hand.
+ */
+
+// Include from exactly one source file (duplicator_game.c); the tables
+// are declared extern where other files need them.
+#ifndef DUPLICATOR_TILE_PROPS_H
+#define DUPLICATOR_TILE_PROPS_H
+
+// Duplication classes (index into tile_dup_types)
+#define DUP_CLASSES 4
+#define DUP_NONE    0xFF  // Tile never duplicates
+
+// Tile type for each duplication class, in resolution order
+const char tile_dup_types[DUP_CLASSES] = { 'p', 'k', '*', 'e' };
+
+// TILE_CAT_* bits for every tile character
+//   ' ' TILE_EMPTY        0x01
+//   '!' TILE_HOLE_B       0x11
+//   '#' TILE_WALL         0x82
+//   '$' TILE_WALL_LINE_A  0x82
+//   '%' TILE_WALL_LINE_B  0x82
+//   '&' TILE_WALL_LINE_G  0x82
+//   '*' TILE_CRATE        0x86
+//   '.' TILE_FLOOR        0x01
+//   '1' TILE_LINE_A       0x01
+//   '2' TILE_LINE_B       0x01
+//   '3' TILE_LINE_C       0x01
+//   '4' TILE_LINE_D       0x01
+//   '5' TILE_LINE_E       0x01
+//   '6' TILE_LINE_F       0x01
+//   '7' TILE_LINE_G       0x01
+//   '8' TILE_LINE_H       0x01
+//   ':' TILE_EXIT_B       0x09
+//   ';' TILE_EXIT_C       0x09
+//   '?' TILE_HOLE_A       0x11
+//   '@' TILE_EXIT_A       0x09
+//   'D' TILE_DOOR_OPEN    0x01
+//   'G' TILE_GATE_A_OPEN  0x41
+//   'H' TILE_GATE_B_OPEN  0x41
+//   '[' TILE_HOLE_A_FILL  0x11
+//   ']' TILE_HOLE_B_FILL  0x11
+//   'b' TILE_PLATE_A      0x21
+//   'c' TILE_PLATE_B      0x21
+//   'd' TILE_DOOR         0x82
+//   'e' TILE_ENEMY        0x86
+//   'g' TILE_GATE_A       0xC2
+//   'h' TILE_GATE_B       0xC2
+//   'k' TILE_KEY          0x86
+//   'p' TILE_PLAYER       0x82
+const byte tile_categories[256] = {
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, // 0x00
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, // 0x10
+    0x01, 0x11, 0x80, 0x82, 0x82, 0x82, 0x82, 0x80, 0x80, 0x80, 0x86, 0x80, 0x80, 0x80, 0x01, 0x80, // 0x20
+    0x80, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x80, 0x09, 0x09, 0x80, 0x80, 0x80, 0x11, // 0x30
+    0x09, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x41, 0x41, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, // 0x40
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x11, 0x80, 0x11, 0x80, 0x80, // 0x50
+    0x80, 0x80, 0x21, 0x21, 0x82, 0x86, 0x80, 0xC2, 0xC2, 0x80, 0x80, 0x86, 0x80, 0x80, 0x80, 0x80, // 0x60
+    0x82, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, // 0x70
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, // 0x80
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, // 0x90
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, // 0xA0
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, // 0xB0
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, // 0xC0
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, // 0xD0
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, // 0xE0
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80  // 0xF0
+};
+
+// Duplication class for every tile character (DUP_NONE if it never duplicates)
+const byte tile_dup_class[256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, // 0x00
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, // 0x10
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x02, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, // 0x20
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, // 0x30
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, // 0x40
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, // 0x50
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x03, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0xFF, 0xFF, 0xFF, 0xFF, // 0x60
+    0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, // 0x70
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, // 0x80
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, // 0x90
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, // 0xA0
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, // 0xB0
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, // 0xC0
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, // 0xD0
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, // 0xE0
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF  // 0xF0
+};
+
+#ifdef ENGINE_HASH
+// Zobrist keys (see HASH_KEY in duplicator_game.c): const, so contexts
+// on different threads share them without any setup
+#ifdef __CC65__
+const state_hash cell_keys[MAP_CELLS] = {
+    0xE124B63AUL, 0x8B9A74ABUL, 0x64E1B3ACUL, 0x00174626UL,
+    0xF2ADBBAFUL, 0xFED75123UL, 0x8A94501AUL, 0x12751A71UL,
+    0x96573F6CUL, 0x46EA7191UL, 0x13D2EA5DUL, 0x9DB4CF31UL,
+    0x8E0F4E18UL, 0x9E43C23EUL, 0x268A56BCUL, 0xE7E1F2D2UL,
+    0xEEC01FEFUL, 0x4A8CA751UL, 0x12BBE422UL, 0xA9CDF49DUL,
+    0xFC95B972UL, 0x3CC0494FUL, 0x88DFC4DBUL, 0x78D703D9UL,
+    0x8D219E6FUL, 0x63680239UL, 0x06CD666EUL, 0xEA1E9EAEUL,
+    0x00A30B2BUL, 0x590D22C8UL, 0x57DFD022UL, 0x16A31F2FUL,
+    0xDD9E740CUL, 0x70E04DE3UL, 0x52DE38EDUL, 0x2DB9938CUL,
+    0xE6CB9168UL, 0x083DB87BUL, 0x59627BA2UL, 0xD4D02589UL,
+    0xDC4CDA99UL, 0xA4E4FBD6UL, 0x485AE539UL, 0x8B4427A7UL,
+    0xF9A8CF9FUL, 0xEB30A9F2UL, 0x3FDC4855UL, 0x6C00D4FEUL,
+    0xA57AD991UL, 0x37585015UL, 0x960739B8UL, 0x57302520UL,
+    0x211591AAUL, 0xF7339F7AUL, 0x1F4F3F94UL, 0xEF05BA8AUL,
+    0x52CE02A0UL, 0xC1D3364DUL, 0x44427DC0UL, 0x74B57F9DUL,
+    0xB390F5FEUL, 0x08C30E49UL, 0x4849434CUL, 0x643E98DCUL,
+    0x538D2A8EUL, 0x2D4EADE0UL, 0xE6A8E2B9UL, 0xA5084706UL,
+    0x10F2EFB2UL, 0xED95AF30UL, 0x5603E229UL, 0x629C364AUL,
+    0x6EF58860UL, 0x20C5141CUL, 0xCA9C72DFUL, 0xDC31A73CUL,
+    0xF21C39B7UL, 0xD0768762UL, 0x13C222CFUL, 0xA4E6C942UL,
+    0xC4184305UL, 0x43682219UL, 0xA24F100CUL, 0x4998B54BUL,
+    0xB90EA0B3UL, 0xCE0631DFUL, 0x0F876DE1UL, 0xA55CA37CUL,
+    0x17544745UL, 0x6829BBFBUL, 0xB5887E50UL, 0xF2064D51UL,
+    0x4E226067UL, 0x47FEAF70UL, 0xD00C2978UL, 0xF1437EC9UL,
+    0x4DD82104UL, 0x76E83AF8UL, 0x47574643UL, 0x5C71400CUL,
+    0xFA6FBCB4UL, 0xB2DE7348UL, 0xEA5EEF73UL, 0xC1A201CBUL,
+    0xB2FF01C6UL, 0x0A3AFC05UL, 0xE2F4ADD8UL, 0x9EBD599FUL,
+    0x845AC858UL, 0x776578F0UL, 0xD7198D6DUL, 0x303F98D7UL,
+    0xA78631E5UL, 0x56EE8638UL, 0x431160ACUL, 0x8F9E32EEUL,
+    0x71B917EFUL, 0x3BDF17EDUL, 0xFD79B4FCUL, 0xB72C70EFUL,
+    0x1F000297UL, 0xF50F4AFEUL, 0x96401E16UL, 0x25D00E37UL,
+    0xA6C97BBCUL, 0xBE695303UL, 0x152659E7UL, 0x1D400BAAUL,
+    0x9A9DF3B0UL, 0xB997D965UL, 0x15D05F38UL, 0xD8DD5443UL,
+    0x38F4A049UL, 0x334710D7UL, 0xFAEE9759UL, 0x28B1C83BUL,
+    0x2762BCE0UL, 0x6F2E177FUL, 0x15F5927FUL, 0x50FE15E2UL,
+    0xDA0184A3UL, 0xB827ACC9UL, 0xFA6BE8D6UL, 0x695C06AEUL,
+    0xD8BFFF2AUL, 0xCC0F3C67UL, 0x5BFAFD66UL, 0x8E91D6EDUL,
+    0x3DC9B5ABUL, 0x64E6D2B5UL, 0x68B5904DUL, 0x8D37FF73UL,
+    0x29ED65FFUL, 0x2F0A2D96UL, 0x3DA3C18AUL, 0xF7C6CB23UL,
+    0xFAF53232UL, 0xCAD8D10BUL, 0xCFC2F797UL, 0xB73BBEEFUL,
+    0xDC21ED1CUL, 0xD1C1A67DUL, 0x44C0EBBAUL, 0x6F476B41UL,
+    0xC7CE4096UL, 0xF44C6878UL, 0x5129CFF9UL, 0x720DA9D2UL,
+    0x21C6C369UL, 0xCCD8683CUL, 0xFA2E92B3UL, 0x2764376FUL,
+    0x90B972CBUL, 0x62E9FADBUL, 0xEBE43442UL, 0xC0E41C74UL,
+    0x2E3D05E1UL, 0x5EAD3681UL, 0xF7D03D5FUL, 0xFF0F0922UL,
+    0xDB4380D7UL, 0xC07F9A1BUL, 0x54A09325UL, 0x9E4618A7UL,
+    0xF70817CEUL, 0x4BC40BF6UL, 0x9DEF7BCBUL, 0x20527280UL,
+    0xAE4AF5A1UL, 0xEF2B161EUL, 0x30FA8DAAUL, 0x48B05CADUL,
+    0x279E7ADFUL, 0xF078391DUL, 0x1C27B4B0UL, 0xBC89FCE8UL,
+    0xE1831122UL, 0xF7450ED1UL, 0x857FB65EUL, 0x053DBF04UL,
+    0xE971AB2AUL, 0x5E842120UL, 0x8EA9C270UL, 0x6A14B963UL,
+    0x5A2C581FUL, 0xF4D5C188UL, 0xD07818BAUL, 0xBE8910ADUL,
+    0x0F032283UL, 0x013D926AUL, 0xDD61F192UL, 0x892BC75BUL,
+    0xC9DB28DBUL, 0x34C3C9DBUL, 0xF2E96BC7UL, 0x2DAD65EFUL,
+    0xA3086987UL, 0x69230DFBUL, 0x1B115F15UL, 0x2E8F0AECUL,
+    0x358F4DA5UL, 0x5B4BF4B8UL, 0x9E402C96UL, 0xE1868E9FUL,
+    0x3AFBA015UL, 0x91DDCA49UL, 0x3A0B3E63UL, 0xE5296080UL,
+    0xEE19879CUL, 0x03A775C9UL, 0x4EDA4B86UL, 0xF2FB8233UL,
+    0xD509CECDUL, 0x76D30C05UL, 0xFD27522CUL, 0xFB39EA3DUL,
+    0x09BB0942UL, 0x7AFCDC6BUL, 0xCF4856B3UL, 0x7654DBFCUL,
+    0x484E8049UL, 0x90BA612AUL, 0x4F76A3C5UL, 0xFAC78602UL,
+    0x4AFFA321UL, 0x6DE051ECUL, 0x9C61A242UL
+};
+
+const state_hash tile_keys[128] = {
+    0xAD1F7C96UL, 0x133E27D0UL, 0x2F4DCA72UL, 0x567BEF13UL,
+    0x58AAC13FUL, 0x11290E59UL, 0x2CA4F328UL, 0xEAF4E348UL,
+    0xA526D8C6UL, 0xB9FADCF9UL, 0xAED434ABUL, 0x206951EBUL,
+    0x40D2ACE1UL, 0xBC9E4E86UL, 0xDC983001UL, 0x8997D4EDUL,
+    0x1243E068UL, 0xA7943EAFUL, 0x28781F6FUL, 0x5928BE05UL,
+    0x93EF1751UL, 0x51A4F5B3UL, 0x2D4CB57AUL, 0xC796B9EBUL,
+    0x05D1E67EUL, 0x1AD964D1UL, 0xFE28A1F0UL, 0xA8CC4B9BUL,
+    0x165853C4UL, 0x983B6754UL, 0x6EE23ABCUL, 0x1F0062A6UL,
+    0x79C1CA8CUL, 0x529D3244UL, 0x6E6CCDEEUL, 0x0DFFB6C6UL,
+    0x9FC661F5UL, 0x2CE5E929UL, 0xA9D0B8E9UL, 0x6775366FUL,
+    0xF6AE60D3UL, 0x6C37ACA9UL, 0xADFACF78UL, 0x76A31B32UL,
+    0xAD6F6BD0UL, 0x42BC309AUL, 0x514D4B6DUL, 0xFC3278DDUL,
+    0xD619A869UL, 0x818BC583UL, 0xDE40FADEUL, 0xE2701033UL,
+    0xEEB60108UL, 0xFC75DE23UL, 0xB182229BUL, 0x4FF63613UL,
+    0xAFB643A9UL, 0x9FA95948UL, 0x24806208UL, 0x30EFBB68UL,
+    0x37D9CD89UL, 0xC375BD1DUL, 0xEE12C9B6UL, 0x53AE16A4UL,
+    0xBE211D39UL, 0x2D480CBAUL, 0xB7340075UL, 0xD06DC6E8UL,
+    0x7EAEA4B0UL, 0xED26C42CUL, 0x81C8815DUL, 0xAD8E5C2CUL,
+    0xA7760A09UL, 0xA0D43B52UL, 0xD073792DUL, 0x55865646UL,
+    0x7695E5C1UL, 0x8F99BA37UL, 0xA33FCD58UL, 0x0808E252UL,
+    0x9C17A613UL, 0x726BBD59UL, 0xBDD36899UL, 0xC8C43FD9UL,
+    0xA8D83086UL, 0x77DC5BA2UL, 0x69A4DB36UL, 0xAA8E28B7UL,
+    0x9C87101BUL, 0xAE0DA479UL, 0x4AD3AE38UL, 0xDD8287F2UL,
+    0x22ECA8CCUL, 0x495B15F6UL, 0x575DC084UL, 0x06EBD362UL,
+    0xEC720901UL, 0x071D8AA8UL, 0x7F52E00CUL, 0x493D4505UL,
+    0xD22F2CABUL, 0xC0F0B9B6UL, 0x2F0458F5UL, 0x274FF5F8UL,
+    0xE7E3B900UL, 0x88BDDD41UL, 0x51A97DABUL, 0xBD987605UL,
+    0xD8497A89UL, 0x141C01A5UL, 0x11359D91UL, 0xF27A7692UL,
+    0x29A57006UL, 0x731B8954UL, 0x441001CCUL, 0xC11DD8D8UL,
+    0x3ADA5EBBUL, 0x50ADC19DUL, 0xFB5CAF92UL, 0xBB75C065UL,
+    0x6C555AF9UL, 0x264936FCUL, 0x12406057UL, 0xD71B6132UL,
+    0xDC92E92CUL, 0xB7521717UL, 0x43A1342FUL, 0xC1B8311DUL
+};
+#else
+const state_hash cell_keys[MAP_CELLS] = {
+    0xE124B63A8B9A74ABULL, 0x64E1B3AC00174626ULL, 0xF2ADBBAFFED75123ULL, 0x8A94501A12751A71ULL,
+    0x96573F6C46EA7191ULL, 0x13D2EA5D9DB4CF31ULL, 0x8E0F4E189E43C23EULL, 0x268A56BCE7E1F2D2ULL,
+    0xEEC01FEF4A8CA751ULL, 0x12BBE422A9CDF49DULL, 0xFC95B9723CC0494FULL, 0x88DFC4DB78D703D9ULL,
+    0x8D219E6F63680239ULL, 0x06CD666EEA1E9EAEULL, 0x00A30B2B590D22C8ULL, 0x57DFD02216A31F2FULL,
+    0xDD9E740C70E04DE3ULL, 0x52DE38ED2DB9938CULL, 0xE6CB9168083DB87BULL, 0x59627BA2D4D02589ULL,
+    0xDC4CDA99A4E4FBD6ULL, 0x485AE5398B4427A7ULL, 0xF9A8CF9FEB30A9F2ULL, 0x3FDC48556C00D4FEULL,
+    0xA57AD99137585015ULL, 0x960739B857302520ULL, 0x211591AAF7339F7AULL, 0x1F4F3F94EF05BA8AULL,
+    0x52CE02A0C1D3364DULL, 0x44427DC074B57F9DULL, 0xB390F5FE08C30E49ULL, 0x4849434C643E98DCULL,
+    0x538D2A8E2D4EADE0ULL, 0xE6A8E2B9A5084706ULL, 0x10F2EFB2ED95AF30ULL, 0x5603E229629C364AULL,
+    0x6EF5886020C5141CULL, 0xCA9C72DFDC31A73CULL, 0xF21C39B7D0768762ULL, 0x13C222CFA4E6C942ULL,
+    0xC418430543682219ULL, 0xA24F100C4998B54BULL, 0xB90EA0B3CE0631DFULL, 0x0F876DE1A55CA37CULL,
+    0x175447456829BBFBULL, 0xB5887E50F2064D51ULL, 0x4E22606747FEAF70ULL, 0xD00C2978F1437EC9ULL,
+    0x4DD8210476E83AF8ULL, 0x475746435C71400CULL, 0xFA6FBCB4B2DE7348ULL, 0xEA5EEF73C1A201CBULL,
+    0xB2FF01C60A3AFC05ULL, 0xE2F4ADD89EBD599FULL, 0x845AC858776578F0ULL, 0xD7198D6D303F98D7ULL,
+    0xA78631E556EE8638ULL, 0x431160AC8F9E32EEULL, 0x71B917EF3BDF17EDULL, 0xFD79B4FCB72C70EFULL,
+    0x1F000297F50F4AFEULL, 0x96401E1625D00E37ULL, 0xA6C97BBCBE695303ULL, 0x152659E71D400BAAULL,
+    0x9A9DF3B0B997D965ULL, 0x15D05F38D8DD5443ULL, 0x38F4A049334710D7ULL, 0xFAEE975928B1C83BULL,
+    0x2762BCE06F2E177FULL, 0x15F5927F50FE15E2ULL, 0xDA0184A3B827ACC9ULL, 0xFA6BE8D6695C06AEULL,
+    0xD8BFFF2ACC0F3C67ULL, 0x5BFAFD668E91D6EDULL, 0x3DC9B5AB64E6D2B5ULL, 0x68B5904D8D37FF73ULL,
+    0x29ED65FF2F0A2D96ULL, 0x3DA3C18AF7C6CB23ULL, 0xFAF53232CAD8D10BULL, 0xCFC2F797B73BBEEFULL,
+    0xDC21ED1CD1C1A67DULL, 0x44C0EBBA6F476B41ULL, 0xC7CE4096F44C6878ULL, 0x5129CFF9720DA9D2ULL,
+    0x21C6C369CCD8683CULL, 0xFA2E92B32764376FULL, 0x90B972CB62E9FADBULL, 0xEBE43442C0E41C74ULL,
+    0x2E3D05E15EAD3681ULL, 0xF7D03D5FFF0F0922ULL, 0xDB4380D7C07F9A1BULL, 0x54A093259E4618A7ULL,
+    0xF70817CE4BC40BF6ULL, 0x9DEF7BCB20527280ULL, 0xAE4AF5A1EF2B161EULL, 0x30FA8DAA48B05CADULL,
+    0x279E7ADFF078391DULL, 0x1C27B4B0BC89FCE8ULL, 0xE1831122F7450ED1ULL, 0x857FB65E053DBF04ULL,
+    0xE971AB2A5E842120ULL, 0x8EA9C2706A14B963ULL, 0x5A2C581FF4D5C188ULL, 0xD07818BABE8910ADULL,
+    0x0F032283013D926AULL, 0xDD61F192892BC75BULL, 0xC9DB28DB34C3C9DBULL, 0xF2E96BC72DAD65EFULL,
+    0xA308698769230DFBULL, 0x1B115F152E8F0AECULL, 0x358F4DA55B4BF4B8ULL, 0x9E402C96E1868E9FULL,
+    0x3AFBA01591DDCA49ULL, 0x3A0B3E63E5296080ULL, 0xEE19879C03A775C9ULL, 0x4EDA4B86F2FB8233ULL,
+    0xD509CECD76D30C05ULL, 0xFD27522CFB39EA3DULL, 0x09BB09427AFCDC6BULL, 0xCF4856B37654DBFCULL,
+    0x484E804990BA612AULL, 0x4F76A3C5FAC78602ULL, 0x4AFFA3216DE051ECULL, 0x9C61A242AD1F7C96ULL,
+    0x133E27D02F4DCA72ULL, 0x567BEF1358AAC13FULL, 0x11290E592CA4F328ULL, 0xEAF4E348A526D8C6ULL,
+    0xB9FADCF9AED434ABULL, 0x206951EB40D2ACE1ULL, 0xBC9E4E86DC983001ULL, 0x8997D4ED1243E068ULL,
+    0xA7943EAF28781F6FULL, 0x5928BE0593EF1751ULL, 0x51A4F5B32D4CB57AULL, 0xC796B9EB05D1E67EULL,
+    0x1AD964D1FE28A1F0ULL, 0xA8CC4B9B165853C4ULL, 0x983B67546EE23ABCULL, 0x1F0062A679C1CA8CULL,
+    0x529D32446E6CCDEEULL, 0x0DFFB6C69FC661F5ULL, 0x2CE5E929A9D0B8E9ULL, 0x6775366FF6AE60D3ULL,
+    0x6C37ACA9ADFACF78ULL, 0x76A31B32AD6F6BD0ULL, 0x42BC309A514D4B6DULL, 0xFC3278DDD619A869ULL,
+    0x818BC583DE40FADEULL, 0xE2701033EEB60108ULL, 0xFC75DE23B182229BULL, 0x4FF63613AFB643A9ULL,
+    0x9FA9594824806208ULL, 0x30EFBB6837D9CD89ULL, 0xC375BD1DEE12C9B6ULL, 0x53AE16A4BE211D39ULL,
+    0x2D480CBAB7340075ULL, 0xD06DC6E87EAEA4B0ULL, 0xED26C42C81C8815DULL, 0xAD8E5C2CA7760A09ULL,
+    0xA0D43B52D073792DULL, 0x558656467695E5C1ULL, 0x8F99BA37A33FCD58ULL, 0x0808E2529C17A613ULL,
+    0x726BBD59BDD36899ULL, 0xC8C43FD9A8D83086ULL, 0x77DC5BA269A4DB36ULL, 0xAA8E28B79C87101BULL,
+    0xAE0DA4794AD3AE38ULL, 0xDD8287F222ECA8CCULL, 0x495B15F6575DC084ULL, 0x06EBD362EC720901ULL,
+    0x071D8AA87F52E00CULL, 0x493D4505D22F2CABULL, 0xC0F0B9B62F0458F5ULL, 0x274FF5F8E7E3B900ULL,
+    0x88BDDD4151A97DABULL, 0xBD987605D8497A89ULL, 0x141C01A511359D91ULL, 0xF27A769229A57006ULL,
+    0x731B8954441001CCULL, 0xC11DD8D83ADA5EBBULL, 0x50ADC19DFB5CAF92ULL, 0xBB75C0656C555AF9ULL,
+    0x264936FC12406057ULL, 0xD71B6132DC92E92CULL, 0xB752171743A1342FULL, 0xC1B8311D34E5A8D0ULL,
+    0xBE02EDCF94D4FE52ULL, 0x68C9C07D480F4BDEULL, 0x8FEFB7E45B7266CDULL, 0xE2D26E184D360B90ULL,
+    0x04CDFBF2CDCF234BULL, 0x1D6CA498B603EC87ULL, 0xB9FE408E4C18B759ULL, 0x0484FE20F356C380ULL,
+    0x4FFC147363304B8AULL, 0x2266EBEA1C615887ULL, 0xD945C4DF5A1C9230ULL, 0xC30435BDF3C55BE4ULL,
+    0x4F8700B85D9AB970ULL, 0x5C23396A5AC2F94DULL, 0xB8802CB81FF93453ULL, 0x171A55AAE84854DDULL,
+    0xB8A33334067E5696ULL, 0x5932E8C08177B075ULL, 0x985C52E9522E06C9ULL, 0xCC1A99F27BB65A60ULL,
+    0xAFBA41BD163FDD1BULL, 0x5E05B175ED47C960ULL, 0x9913A9F569828383ULL, 0x07AD103A10EA5F0FULL,
+    0x3A79C3CA4210DB8AULL, 0x7557507A7453A516ULL, 0x1EDDC8AE5EC3320AULL, 0x28CFA72B597F8EFEULL,
+    0xBCA34F6E7C925CE9ULL, 0xD6E38AAE517537D5ULL, 0x06726E523CB97A4EULL, 0x6DE6C5761C43A592ULL,
+    0x76CBECAA608B89A5ULL, 0x265B0E3AB411D374ULL, 0x419D9D2BB52802D7ULL, 0x1B25B5AE1F944FA6ULL,
+    0x5A78565646E57FEFULL, 0xCA058703265E9451ULL, 0x6E4D095B23A7D3E8ULL, 0xE28D5FA56642B839ULL,
+    0x19F593FBDADE61FEULL, 0xCAD4FB4EE21F2390ULL, 0xCBC9346645F5DA44ULL, 0x2919865A238B9CD3ULL,
+    0x522B4FBB405A78F5ULL, 0xE7DF35B72C537563ULL, 0x1D19B79C56AE6F49ULL, 0xF3A75FAA121063E3ULL,
+    0xD3ED96754543DA64ULL, 0xFFE7E9035A368460ULL, 0xDDE2E69DA711C6A5ULL, 0x676001A78DCE93ADULL,
+    0xA8D89270E84F285BULL, 0xA5CD91D9E921FE62ULL, 0x0B57779451152D86ULL, 0x60176D543A08DACAULL,
+    0x0B60C622673571F0ULL, 0xE869BBD53D7DFFDCULL, 0xD241ED7F12212B88ULL
+};
+
+const state_hash tile_keys[128] = {
+    0xDD563420619500E9ULL, 0xF080458DFE02AB35ULL, 0xC7EF8E67F24DDBB6ULL, 0x6E5CDA4B57ADD8E1ULL,
+    0x7A80599947DB6940ULL, 0x749CFB19940A7226ULL, 0x93953F21BA51A639ULL, 0x5C4EEF32B4B51326ULL,
+    0xCCEAD18E4DB00683ULL, 0xE1684653DDE802C2ULL, 0x6BB5AF5A158E8ED5ULL, 0x4EDDD31F63776140ULL,
+    0x64BBFB0F6098CAA2ULL, 0x405A7EC4FFDDD9A5ULL, 0xD9C221F12275AEEFULL, 0x62A8A25BAA9CDC6AULL,
+    0x132118A2369D57B8ULL, 0x1129282DB1BED55BULL, 0x09A59AF1E587160CULL, 0xEF94204F182345A1ULL,
+    0x627CE0AA33522C5EULL, 0xADE33172B26F8614ULL, 0x1709CF02F3DA96B6ULL, 0x808CC03009D342D5ULL,
+    0x50B3903174018C0BULL, 0xF59917AB3AEF9FBDULL, 0xEA133D113B9A22E9ULL, 0x87209C4A019B55DEULL,
+    0x0F34A98EDAA1B50CULL, 0x6C08228C636B42A0ULL, 0x6CD7A0DF814D9B99ULL, 0x75EAF2465FE6D577ULL,
+    0x2C468DB343E2FA2BULL, 0x88551B784C7BD245ULL, 0xF05E42DC38BE051EULL, 0xFBAA9B10B1D121F4ULL,
+    0x28128B6356A42C5CULL, 0xB6D77CAB7104314AULL, 0x128C515C8C543CEFULL, 0x72F2F86B920E5C14ULL,
+    0x6812EA929D56B672ULL, 0x3882A47EEDA71D78ULL, 0xCF0B55FC132463E6ULL, 0x7445650AC46D6678ULL,
+    0x7CE81709BF2809ADULL, 0x7DA322C3269289FEULL, 0x82033728782EEE3BULL, 0x18D2452F5E862F94ULL,
+    0xF5E8A7EEC3B7FBE4ULL, 0xA5A7D5A1BD689F28ULL, 0x7F34C5AE17AFBBAEULL, 0xFB9B73A3280473D4ULL,
+    0x69AABD8BFD639246ULL, 0x6A49AFB3A843EDECULL, 0x6A3EE573648B195BULL, 0xF3AF2BEBCC9A50C2ULL,
+    0x56C823E304393D99ULL, 0x52CB87DC6432CE44ULL, 0x82B04799C22775B8ULL, 0xBE9C1DF099626F41ULL,
+    0x45CE85843AB7A85BULL, 0x38295F256A732EA3ULL, 0xFB4E6770C3AFE8A0ULL, 0xE9C5085D511F0B7AULL,
+    0xBE727B02D35A32EBULL, 0x35E415685E60974CULL, 0xDDAF1008CA6FF43FULL, 0xA9E9C72BB0911A0DULL,
+    0xE9CE8F453CE05996ULL, 0xCD82CD9F121D9767ULL, 0xBED5C4FFCF0EDC9AULL, 0x872F4C54BA1A9BC6ULL,
+    0xC527C1979FB2DCBDULL, 0x4086CB4FA40390B8ULL, 0x148B8DF2C38A1268ULL, 0xB92D03EB335D8723ULL,
+    0xF48D791F2E782DC8ULL, 0x53E63D281C2D9629ULL, 0x73F4CAFDBFC8EAA8ULL, 0xF12AC72690042BE1ULL,
+    0xBA782AFD5BDD78AEULL, 0x6DD09B8AAA9D7F9AULL, 0xA8A9988DECB6DF71ULL, 0xDC447F7D26D523A8ULL,
+    0xD6AC3DF87371BB51ULL, 0xC76C92DCF3D030A7ULL, 0x4D51E2E550A23603ULL, 0xDA29FB724DBEF3F1ULL,
+    0xEBD3D8318A63BB3BULL, 0x5D901299A7A0B278ULL, 0x8C12BB6FB499ECD0ULL, 0xA976A271DA2F214DULL,
+    0xFED5578ED0B30E1CULL, 0x9F6A02243AF35BD3ULL, 0x60AB71F7DC27411DULL, 0xB49B98FF37077C9DULL,
+    0xCA02AA3777C4B735ULL, 0xC56E9324F6490C81ULL, 0x2CF1AACD2CA8C539ULL, 0xB5F018FE6B1FF2A9ULL,
+    0x3C19998CEA2BDD18ULL, 0xA09A2E5C4F6A4274ULL, 0xE3BCFD26FF18666AULL, 0x897EAF80CD5EB927ULL,
+    0x5530D75AB4ADA657ULL, 0x0C8F8AE447BDF5ADULL, 0xD80D0C09480E092FULL, 0xAC5E1AFA8F2CC23AULL,
+    0xFA1AB86F0FF6D264ULL, 0x62FD2F9926C3EFDEULL, 0x3C384A029A7A077EULL, 0x8820ECB42372EB8FULL,
+    0xBE65A54E53406528ULL, 0xA34C119A0E976585ULL, 0xA6D12656C16F4C3BULL, 0x35EF31AFA88DB002ULL,
+    0xCF3217C43490F501ULL, 0x6C28C339FDB4FADEULL, 0x3F0E7E89EB3BFA26ULL, 0x1B9173398B3F7182ULL,
+    0xC4EF63A53BE12AE8ULL, 0xC9389376B191E57DULL, 0x2AFE7FA24443E9C7ULL, 0x1619BA3A0A83B835ULL,
+    0xCD21F817B64F41C6ULL, 0x9082715D0B9E7F29ULL, 0x4B1C9F94C5200F83ULL, 0x5ED1B08B70DC798BULL
+};
+#endif
+#endif
+
+#endif // DUPLICATOR_TILE_PROPS_H
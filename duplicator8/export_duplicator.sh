@@ -16,6 +16,7 @@ FILES=(
     "duplicator_font.h"
     "duplicator_game.c"
     "duplicator_game.h"
+    "duplicator_tile_props.h"
     "duplicator_test.c"
 )
 
@@ -3,6 +3,7 @@
 
 // Link the 16x16 mode libraries
 //#link "duplicator_conio_16x16.c"
+//#link "tile_blit_16x16.s"
 //#link "duplicator_tile_map_16x16.c"
 //#link "duplicator_game_16x16.c"
 
@@ -12,6 +13,14 @@
 
   This version displays each game tile as a 2x2 block of characters,
   making tiles 4x bigger and much easier to see!
+
+  Build every source with -DFRAME_HUD to show how many scanlines each
+  engine stage of the last turn took, in the rows above the level. The
+  frame length is read from GTIA at startup, so the HUD works on both
+  NTSC and PAL machines.
+
+  Build every source with -DENGINE_UNDO to record an undo timeline and
+  bind U to undo and Y to redo (costs over 1 KB of RAM).
 */
 
 #include <stdlib.h>
@@ -41,7 +50,7 @@ typedef unsigned short word;
 #include "duplicator_graphics_16x16.h"  // Pre-scaled 16x16 graphics
 
 #include "duplicator_game.h"
-#include "duplicator_levels_16x16.h"    // Level definitions
+#include "duplicator_levels_16x16_packed.h"  // Level definitions (see test/level_compiler.c)
 
 // Graphics setup function for 16x16 mode
 void setup_duplicator_graphics(void) {
@@ -91,6 +100,152 @@ void setup_duplicator_graphics(void) {
     POKE(752, 1);
 }
 
+// Screen buffers: the display list shows one while full redraws are
+// built in the other
+static byte* visible_screen = SCREEN_MEM;
+static byte* hidden_screen = SCREEN_MEM_2;
+
+// Point the display list LMS at a screen buffer
+// (call during vblank so the frame being drawn doesn't change buffer)
+static void show_screen(byte* screen) {
+    DLIST_MEM[4] = (byte)(word)screen;
+    DLIST_MEM[5] = (byte)((word)screen >> 8);
+}
+
+#ifdef FRAME_HUD
+// Frame-time HUD: VCOUNT is sampled as each engine stage starts (via the
+// ENGINE_STAGE hook) and around the flush. The top character row shows
+// the last turn as a stacked bar, one cell per HUD_LINES_PER_CELL VCOUNT
+// steps, with a marker at one frame below it; the third row counts turns
+// whose stages and flush took more than a frame.
+#define VCOUNT (*(volatile byte*)0xD40B)  // ANTIC scanline counter / 2
+#define RTCLOK (*(volatile byte*)0x14)    // OS frame counter (bumped in vblank)
+#define GTIA_PAL (*(volatile byte*)0xD014)  // Bits 1-3 clear on PAL machines
+#define NTSC_FRAME_LINES 131              // VCOUNT steps per NTSC frame
+#define PAL_FRAME_LINES 156               // VCOUNT steps per PAL frame
+#define HUD_LINES_PER_CELL 4
+#define HUD_FLUSH STAGE_END               // Bar segment after the engine stages
+#define HUD_SEGMENTS (STAGE_END + 1)
+#define HUD_BAR_ROW 0
+#define HUD_FRAME_ROW 1
+#define HUD_OVERRUN_ROW 2
+
+// Bar character for each segment: undo recording, players, duplication,
+// gates, enemies, flush
+static const byte hud_chars[HUD_SEGMENTS] = {
+    KEY | 0x80, PLAYER | 0x80, HOLE_A | 0x80, GATE_A | 0x80, ENEMY | 0x80, FLOOR | 0x80
+};
+
+static word hud_lines[HUD_SEGMENTS];  // VCOUNT steps per segment of the last turn
+static byte hud_stage = STAGE_END;    // Stage being timed
+static byte hud_turn;                 // A turn ran since the HUD was drawn
+static byte hud_overruns;
+static byte hud_frame, hud_line;      // Last sample
+static byte frame_lines;              // VCOUNT steps per frame (hud_init)
+
+// Pick the frame length of the video standard we run on
+static void hud_init(void) {
+    frame_lines = (GTIA_PAL & 0x0E) ? NTSC_FRAME_LINES : PAL_FRAME_LINES;
+}
+
+// VCOUNT steps since the last sample; stages longer than a frame are
+// measured with the frame counter
+static word hud_split(void) {
+    byte frame = RTCLOK;
+    byte line = VCOUNT;
+    int lines = (int)(byte)(frame - hud_frame) * frame_lines + line - hud_line;
+
+    // RTCLOK ticks a few lines before VCOUNT wraps
+    if (lines < 0) {
+        lines += frame_lines;
+    }
+    hud_frame = frame;
+    hud_line = line;
+    return (word)lines;
+}
+
+// Called by try_move_player as each stage starts
+void engine_stage(byte stage) {
+    word lines = hud_split();
+
+    if (hud_stage == STAGE_END) {
+        // First stage of a turn
+        memset(hud_lines, 0, sizeof(hud_lines));
+        hud_turn = 1;
+    } else {
+        hud_lines[hud_stage] += lines;
+    }
+    hud_stage = stage;
+}
+
+// Draw a run of one character into a HUD row, clearing the rest
+static void hud_fill(byte row, byte from, byte to, byte ch) {
+    byte* line = visible_screen + row * CHAR_COLS;
+
+    if (to > CHAR_COLS) {
+        to = CHAR_COLS;
+    }
+    while (from < to) {
+        line[from++] = ch;
+    }
+}
+
+static void hud_draw(void) {
+    word total = 0;
+    word cells;
+    byte seg, col = 0, end;
+
+    for (seg = 0; seg < HUD_SEGMENTS; seg++) {
+        total += hud_lines[seg];
+        cells = (total + HUD_LINES_PER_CELL - 1) / HUD_LINES_PER_CELL;
+        end = cells > CHAR_COLS ? CHAR_COLS : (byte)cells;
+        hud_fill(HUD_BAR_ROW, col, end, hud_chars[seg]);
+        col = end;
+    }
+    hud_fill(HUD_BAR_ROW, col, CHAR_COLS, 0);
+
+    if (total > frame_lines && hud_overruns < 255) {
+        hud_overruns++;
+    }
+    hud_fill(HUD_FRAME_ROW, 0, CHAR_COLS, 0);
+    hud_fill(HUD_FRAME_ROW, frame_lines / HUD_LINES_PER_CELL, frame_lines / HUD_LINES_PER_CELL + 1, EXIT_A | 0x80);
+    hud_fill(HUD_OVERRUN_ROW, 0, hud_overruns, ENEMY | 0x80);
+}
+#endif
+
+// Show this turn's changes (call right after vblank)
+static void flush_turn(void) {
+#ifdef FRAME_HUD
+    hud_split();
+    flush_dirty_cells();
+    if (hud_turn) {
+        hud_lines[HUD_FLUSH] = hud_split();
+        hud_draw();
+        hud_turn = 0;
+    }
+#else
+    flush_dirty_cells();
+#endif
+}
+
+// Load a level and draw it off-screen, then swap it in at vblank
+static void show_level(byte level) {
+    byte* screen;
+
+    my_set_draw_screen_16x16(hidden_screen);
+    my_clrscr_16x16();
+    load_packed_level(packed_levels[level]);
+    draw_level();
+
+    wait_vblank_16x16();
+    show_screen(hidden_screen);
+
+    // Keep drawing per-turn changes into the buffer now on display
+    screen = visible_screen;
+    visible_screen = hidden_screen;
+    hidden_screen = screen;
+}
+
 // Main function
 void main(void) {
     byte joy, last_joy = 0;
@@ -103,13 +258,12 @@ void main(void) {
 
     // Setup graphics
     setup_duplicator_graphics();
-
-    // Clear screen
-    my_clrscr_16x16();
+#ifdef FRAME_HUD
+    hud_init();
+#endif
 
     // Load first level
-    load_level(levels[current_level], 11);
-    draw_level();
+    show_level(current_level);
 
     // Main game loop
     while (1) {
@@ -141,10 +295,15 @@ void main(void) {
                 try_move_player(-1, 0);
             } else if (key == CH_CURS_RIGHT || key == 'd' || key == 'D') {
                 try_move_player(1, 0);
+#ifdef ENGINE_UNDO
+            } else if (key == 'u' || key == 'U') {
+                undo_turn();
+            } else if (key == 'y' || key == 'Y') {
+                redo_turn();
+#endif
             } else if (key == 'r' || key == 'R') {
-                // Restart level
-                load_level(levels[current_level], 11);
-                draw_level();
+                // Restart level (redraws only the cells that changed)
+                restart_level();
             } else if (key == CH_ESC) {
                 break;  // Exit game
             }
@@ -155,16 +314,17 @@ void main(void) {
         if (state->num_players > 0 && is_level_complete()) {
             // Level complete!
             current_level++;
-            if (current_level >= NUM_LEVELS) {
+            if (current_level >= NUM_PACKED_LEVELS) {
                 // Game complete!
                 break;
             }
             // Load next level
-            load_level(levels[current_level], 11);
-            draw_level();
+            show_level(current_level);
         }
 
+        // Show this turn's changes while the beam is off screen
         wait_vblank_16x16();
+        flush_turn();
     }
 }
 
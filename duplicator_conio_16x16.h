@@ -24,12 +24,23 @@ typedef unsigned short word;
 
 // Memory locations
 #define SCREEN_MEM  ((byte*)0x9000)
+#define SCREEN_MEM_2 ((byte*)0x9800)  // Second buffer for off-screen redraws (page aligned)
 
 // Function prototypes for 16x16 mode
 void my_clrscr_16x16(void);
-void my_cputcxy_16x16(byte tx, byte ty, byte tile_char);
 void wait_vblank_16x16(void);
 
+// Draw a 2x2 tile (4 consecutive screen codes from tile_char, 0 = empty)
+// Implemented in tile_blit_16x16.s
+void __fastcall__ my_cputcxy_16x16(byte tx, byte ty, byte tile_char);
+
+// High byte of the screen buffer the blitter draws into (tile_blit_16x16.s)
+extern byte tile_screen_page;
+
+// Select the screen buffer (SCREEN_MEM or SCREEN_MEM_2) that the drawing
+// functions write to; it does not change which buffer is displayed
+void my_set_draw_screen_16x16(byte* screen);
+
 // Tile mapping function (defined in duplicator_tile_map_16x16.c)
 byte map_tile_to_16x16(byte tile);
 
@@ -37,6 +48,7 @@ byte map_tile_to_16x16(byte tile);
 // These are implemented in duplicator_conio_16x16.c
 void my_cputcxy(byte x, byte y, byte character);
 void my_clrscr(void);
+void my_set_draw_screen(byte* screen);
 void my_cputsxy(byte x, byte y, const char* str);
 void my_cprintf_status(byte b, byte t, byte m);
 void wait_vblank(void);
@@ -0,0 +1,217 @@
+/*
+  Duplicator Game - Packed Level Data for 16x16 Mode
+
+  Generated from duplicator_levels_16x16.h by test/level_compiler.c;
+  edit the levels there and run test/build_level_compiler.sh.
+  Each level is loaded with load_packed_level(packed_levels[n]).
+*/
+
+#ifndef DUPLICATOR_LEVELS_16X16_PACKED_H
+#define DUPLICATOR_LEVELS_16X16_PACKED_H
+
+const unsigned char packed_level_1[] = {
+    0x11, 0x0B, 0x18, 0x1F, 0xF1, 0x11, 0x1F, 0xF1, 0x11, 0x1F, 0xF1, 0x30, 0x31, 0x3A, 0x31, 0x3A,
+    0x31, 0x0F, 0xF1, 0x11, 0x04, 0x03, 0x1B, 0x3A, 0xA0, 0x70, 0xA4, 0x65
+};
+
+const unsigned char packed_level_2[] = {
+    0x11, 0x0B, 0xFF, 0x37, 0x31, 0x31, 0xB6, 0x36, 0x31, 0x31, 0x17, 0x17, 0x18, 0x32, 0x12, 0xD8,
+    0x37, 0x0F, 0xF1, 0x11, 0x08, 0x0C, 0x50, 0x21, 0x51, 0x32, 0x52, 0x25, 0x53, 0x32, 0x54, 0x3F,
+    0x58, 0x62, 0x6B, 0x31, 0x7E, 0x24, 0x91, 0x24, 0xA4, 0x67, 0xA8, 0x40, 0xD9, 0x70
+};
+
+const unsigned char packed_level_3[] = {
+    0x11, 0x0B, 0xFF, 0x37, 0x31, 0x31, 0xB6, 0x36, 0x31, 0x31, 0x17, 0x17, 0x77, 0x12, 0xF4, 0x32,
+    0xF7, 0xBF, 0x0F, 0x50, 0x21, 0x51, 0x32, 0x52, 0x25, 0x53, 0x32, 0x54, 0x3F, 0x58, 0x62, 0x6B,
+    0x31, 0x7E, 0x24, 0x91, 0x24, 0x98, 0x70, 0xA0, 0x63, 0xA1, 0x32, 0xA2, 0x68, 0xA4, 0x67, 0xA8,
+    0x40
+};
+
+const unsigned char packed_level_4[] = {
+    0x11, 0x0B, 0x1C, 0x1F, 0x71, 0x13, 0x13, 0x63, 0x17, 0x36, 0x13, 0x13, 0x73, 0x31, 0xB1, 0x13,
+    0x37, 0x16, 0x3A, 0x13, 0xF7, 0x7F, 0x0E, 0x50, 0x21, 0x51, 0x32, 0x52, 0x25, 0x53, 0x32, 0x54,
+    0x3F, 0x8F, 0x64, 0x91, 0x64, 0x98, 0x70, 0xA0, 0x6B, 0xA2, 0x64, 0xA4, 0x64, 0xA8, 0x40, 0xB5,
+    0x64, 0xB7, 0x64
+};
+
+const unsigned char packed_level_5[] = {
+    0x11, 0x0B, 0x18, 0x1F, 0xA1, 0x4D, 0x37, 0x43, 0x73, 0x43, 0x4D, 0x73, 0x23, 0x75, 0x43, 0x4D,
+    0xFD, 0x04, 0x35, 0x1B, 0x40, 0x3B, 0x36, 0x3C, 0x32, 0x3D, 0x32, 0x3E, 0x32, 0x3F, 0x63, 0x40,
+    0x67, 0x41, 0x32, 0x42, 0x25, 0x43, 0x25, 0x44, 0x25, 0x45, 0x32, 0x46, 0x32, 0x47, 0x33, 0x4E,
+    0x31, 0x53, 0x67, 0x5A, 0x31, 0x61, 0x31, 0x6D, 0x31, 0x74, 0x31, 0x75, 0x3F, 0x76, 0x32, 0x77,
+    0x25, 0x78, 0x25, 0x79, 0x25, 0x7A, 0x25, 0x7B, 0x25, 0x7C, 0x25, 0x7D, 0x25, 0x7E, 0x32, 0x7F,
+    0x21, 0x80, 0x31, 0x87, 0x31, 0x93, 0x31, 0x98, 0x70, 0x9A, 0x31, 0xA6, 0x31, 0xAD, 0x31, 0xB2,
+    0x68, 0xB9, 0x31, 0xC0, 0x35, 0xC1, 0x32, 0xC2, 0x32, 0xC3, 0x32, 0xC4, 0x32, 0xC5, 0x68, 0xC6,
+    0x62, 0xC7, 0x32, 0xC8, 0x32, 0xC9, 0x32, 0xCA, 0x32, 0xCB, 0x32, 0xCC, 0x34
+};
+
+const unsigned char packed_level_6[] = {
+    0x11, 0x0B, 0x18, 0x1F, 0xB1, 0x17, 0x63, 0x13, 0x67, 0x13, 0x13, 0x63, 0x7A, 0x13, 0x13, 0x63,
+    0x13, 0x13, 0x63, 0x13, 0x13, 0xB3, 0xF1, 0x11, 0x08, 0x19, 0x1B, 0x40, 0x2E, 0x67, 0x3C, 0x36,
+    0x3D, 0x32, 0x3E, 0x32, 0x3F, 0x25, 0x40, 0x32, 0x41, 0x34, 0x4F, 0x31, 0x62, 0x31, 0x75, 0x24,
+    0x76, 0x21, 0x77, 0x25, 0x78, 0x25, 0x79, 0x25, 0x7A, 0x32, 0x7B, 0x25, 0x7C, 0x25, 0x7D, 0x25,
+    0x7E, 0x3F, 0x88, 0x31, 0x9B, 0x35, 0x9C, 0x62, 0xA4, 0x2A, 0xD9, 0x70
+};
+
+const unsigned char packed_level_7[] = {
+    0x11, 0x0B, 0x13, 0x1F, 0xF1, 0xC1, 0xC5, 0x1B, 0x14, 0xA5, 0x11, 0xC5, 0xC5, 0xC5, 0x1A, 0x1F,
+    0x81, 0x10, 0x16, 0x40, 0x3D, 0x64, 0x41, 0x64, 0x44, 0x2A, 0x45, 0x21, 0x46, 0x6B, 0x50, 0x64,
+    0x54, 0x64, 0x55, 0x36, 0x56, 0x32, 0x57, 0x32, 0x58, 0x34, 0x68, 0x24, 0x7B, 0x3F, 0x7D, 0x2A,
+    0xD9, 0x70
+};
+
+const unsigned char packed_level_8[] = {
+    0x11, 0x0B, 0x4F, 0x23, 0x23, 0x43, 0x4D, 0x23, 0x23, 0x53, 0x41, 0x41, 0x61, 0x41, 0x41, 0x51,
+    0x23, 0x23, 0x43, 0x23, 0x2A, 0x23, 0x23, 0x53, 0xF1, 0x11, 0x0D, 0x0B, 0x3C, 0x21, 0x41, 0x6B,
+    0x4F, 0x31, 0x62, 0x24, 0x75, 0x24, 0x88, 0x31, 0x9B, 0x3F, 0xA0, 0x65, 0xA7, 0x64, 0xA8, 0x40,
+    0xD4, 0x70
+};
+
+const unsigned char packed_level_9[] = {
+    0x11, 0x0B, 0x4F, 0x35, 0x45, 0x4D, 0x35, 0x45, 0x4D, 0x35, 0x45, 0x2D, 0x37, 0xF7, 0xFF, 0x06,
+    0x08, 0x41, 0x2A, 0x45, 0x65, 0x67, 0x2A, 0x6B, 0x65, 0x8D, 0x2A, 0x91, 0x65, 0x98, 0x70, 0xA8,
+    0x40
+};
+
+const unsigned char packed_level_10[] = {
+    0x11, 0x0B, 0x9F, 0x7A, 0x43, 0x91, 0x43, 0xA1, 0x51, 0x71, 0x6B, 0x21, 0x21, 0x51, 0xFC, 0xFF,
+    0x0B, 0x15, 0x30, 0x68, 0x31, 0x32, 0x32, 0x32, 0x33, 0x32, 0x34, 0x33, 0x36, 0x40, 0x41, 0x21,
+    0x47, 0x24, 0x54, 0x31, 0x5A, 0x24, 0x67, 0x24, 0x6D, 0x24, 0x7A, 0x31, 0x7F, 0x65, 0x80, 0x35,
+    0x81, 0x63, 0x8D, 0x24, 0x98, 0x70, 0x9B, 0x62, 0x9C, 0x67, 0xA0, 0x3F
+};
+
+const unsigned char packed_level_11[] = {
+    0x11, 0x0B, 0x18, 0x98, 0x29, 0x13, 0x8B, 0x49, 0x31, 0x3E, 0xAF, 0x2F, 0x2F, 0x2F, 0x2F, 0x0E,
+    0x1B, 0x40, 0x26, 0x70, 0x29, 0x68, 0x2A, 0x68, 0x2B, 0x32, 0x2C, 0x33, 0x3F, 0x24, 0x4F, 0x3F,
+    0x50, 0x32, 0x51, 0x25, 0x52, 0x26, 0x53, 0x21, 0x65, 0x24, 0x78, 0x63
+};
+
+const unsigned char packed_level_12[] = {
+    0x11, 0x0B, 0xFF, 0x69, 0xE8, 0x13, 0x62, 0x14, 0x13, 0x17, 0x24, 0x12, 0xB2, 0xE3, 0x13, 0x62,
+    0x18, 0x1F, 0xE1, 0x1F, 0x50, 0x67, 0x55, 0x2A, 0x56, 0x36, 0x57, 0x3F, 0x5B, 0x62, 0x61, 0x2A,
+    0x69, 0x31, 0x6E, 0x68, 0x74, 0x2A, 0x7C, 0x24, 0x81, 0x31, 0x82, 0x40, 0x87, 0x2A, 0x8A, 0x36,
+    0x8B, 0x32, 0x8C, 0x32, 0x8D, 0x32, 0x8E, 0x32, 0x8F, 0x37, 0x90, 0x25, 0x91, 0x25, 0x92, 0x25,
+    0x93, 0x25, 0x94, 0x68, 0x9B, 0x63, 0x9C, 0x68, 0x9D, 0x34, 0xA1, 0x2A, 0xA2, 0x35, 0xA3, 0x21,
+    0xD3, 0x70
+};
+
+const unsigned char packed_level_13[] = {
+    0x11, 0x0B, 0x1D, 0x67, 0x13, 0x17, 0x23, 0x13, 0xD4, 0x14, 0x12, 0x23, 0xA7, 0xA9, 0x37, 0x3E,
+    0x3E, 0xEF, 0x1B, 0x20, 0x40, 0x2A, 0x65, 0x4D, 0x62, 0x50, 0x21, 0x51, 0x32, 0x52, 0x32, 0x53,
+    0x32, 0x54, 0x33, 0x55, 0x36, 0x56, 0x32, 0x57, 0x67, 0x60, 0x24, 0x67, 0x31, 0x68, 0x31, 0x72,
+    0x70, 0x73, 0x35, 0x74, 0x32, 0x75, 0x32, 0x76, 0x32, 0x77, 0x25, 0x78, 0x25, 0x79, 0x25, 0x7A,
+    0x37, 0x7B, 0x34, 0x88, 0x2A, 0x8D, 0x3F, 0xAE, 0x2A
+};
+
+const unsigned char packed_level_14[] = {
+    0x11, 0x0B, 0x3F, 0x89, 0x89, 0x89, 0x33, 0x83, 0x33, 0x83, 0x33, 0x29, 0x39, 0x11, 0x21, 0x1D,
+    0x21, 0x39, 0x11, 0xD2, 0x31, 0x0D, 0x3A, 0x65, 0x3B, 0x6B, 0x3C, 0x65, 0x90, 0x62, 0x91, 0x67,
+    0x93, 0x64, 0xB3, 0x21, 0xB4, 0x32, 0xB5, 0x25, 0xB6, 0x25, 0xB7, 0x3F, 0xCE, 0x40, 0xDE, 0x70
+};
+
+const unsigned char packed_level_15[] = {
+    0x11, 0x0B, 0x3F, 0x0F, 0xF2, 0x20, 0x0F, 0xF2, 0x20, 0x0F, 0xF2, 0x11, 0x0F, 0x37, 0x98, 0xAF,
+    0x1A, 0x2C, 0x21, 0x2E, 0x3F, 0x32, 0x65, 0x33, 0x64, 0x35, 0x64, 0x3F, 0x35, 0x40, 0x32, 0x41,
+    0x34, 0x46, 0x64, 0x48, 0x64, 0x59, 0x64, 0x5B, 0x64, 0x6C, 0x64, 0x6E, 0x64, 0x74, 0x65, 0x7F,
+    0x64, 0x81, 0x64, 0x92, 0x64, 0x94, 0x64, 0x95, 0x40, 0xA5, 0x64, 0xA7, 0x64, 0xB2, 0x6B, 0xBE,
+    0x70, 0xC2, 0x63, 0xC3, 0x68
+};
+
+const unsigned char packed_level_16[] = {
+    0x11, 0x0B, 0xEF, 0xC5, 0x53, 0x28, 0x61, 0x14, 0x11, 0x21, 0x43, 0x14, 0x11, 0x14, 0x11, 0x1F,
+    0xD4, 0x1F, 0xF1, 0x11, 0x3F, 0x1B, 0x34, 0x64, 0x36, 0x40, 0x47, 0x64, 0x4F, 0x36, 0x50, 0x32,
+    0x51, 0x32, 0x52, 0x32, 0x53, 0x25, 0x54, 0x32, 0x55, 0x32, 0x56, 0x33, 0x59, 0x67, 0x62, 0x31,
+    0x69, 0x21, 0x6C, 0x67, 0x6D, 0x25, 0x6E, 0x62, 0x75, 0x31, 0x85, 0x70, 0x88, 0x31, 0x8C, 0x68,
+    0x9B, 0x3F, 0x9D, 0x63, 0x9E, 0x32, 0x9F, 0x68, 0xA5, 0x6B, 0xCD, 0x65
+};
+
+const unsigned char packed_level_17[] = {
+    0x11, 0x0B, 0x2F, 0x2F, 0x94, 0x18, 0x23, 0x1B, 0x41, 0x12, 0x98, 0x18, 0x42, 0x11, 0x18, 0x22,
+    0x13, 0x18, 0x13, 0x13, 0xC5, 0x6F, 0x25, 0x26, 0x70, 0x28, 0x63, 0x29, 0x68, 0x2E, 0x3F, 0x32,
+    0x36, 0x33, 0x32, 0x34, 0x67, 0x36, 0x40, 0x3D, 0x36, 0x3E, 0x25, 0x3F, 0x25, 0x40, 0x25, 0x41,
+    0x37, 0x42, 0x25, 0x43, 0x25, 0x44, 0x25, 0x45, 0x34, 0x50, 0x31, 0x54, 0x35, 0x55, 0x33, 0x63,
+    0x31, 0x68, 0x31, 0x76, 0x31, 0x7A, 0x65, 0x7B, 0x35, 0x7C, 0x32, 0x7D, 0x32, 0x7E, 0x21, 0x89,
+    0x31, 0x9C, 0x24, 0xA0, 0x2A, 0xAF, 0x31, 0xB3, 0x2A, 0xBF, 0x62, 0xC0, 0x32, 0xC1, 0x32, 0xC2,
+    0x34
+};
+
+const unsigned char packed_level_18[] = {
+    0x11, 0x0B, 0x1D, 0xE3, 0x98, 0x98, 0x98, 0x98, 0x98, 0x98, 0x98, 0x98, 0x5F, 0x24, 0x20, 0x40,
+    0x26, 0x70, 0x28, 0x63, 0x29, 0x68, 0x2F, 0x3F, 0x30, 0x32, 0x31, 0x33, 0x32, 0x36, 0x33, 0x67,
+    0x3E, 0x2A, 0x3F, 0x2A, 0x40, 0x2A, 0x41, 0x2A, 0x43, 0x2A, 0x44, 0x31, 0x45, 0x31, 0x57, 0x31,
+    0x58, 0x31, 0x6A, 0x31, 0x6B, 0x31, 0x7D, 0x31, 0x7E, 0x31, 0x90, 0x31, 0x91, 0x31, 0xA3, 0x31,
+    0xA4, 0x31, 0xB6, 0x35, 0xB7, 0x37, 0xB8, 0x21, 0xC3, 0x65, 0xC4, 0x65, 0xC5, 0x65, 0xC6, 0x65,
+    0xC7, 0x65, 0xCA, 0x35, 0xCB, 0x62
+};
+
+const unsigned char packed_level_19[] = {
+    0x11, 0x0B, 0xFF, 0xFF, 0xFF, 0xEF, 0x8E, 0x71, 0x31, 0x1C, 0xF1, 0x11, 0x03, 0x0B, 0x98, 0x3B,
+    0x9D, 0x67, 0xA3, 0x21, 0xA4, 0x68, 0xA5, 0x63, 0xB0, 0x24, 0xBE, 0x3B, 0xC3, 0x67, 0xC4, 0x62,
+    0xC9, 0x3F, 0xDE, 0x70
+};
+
+const unsigned char packed_level_20[] = {
+    0x11, 0x0B, 0x18, 0x98, 0x29, 0x13, 0x8B, 0x49, 0x31, 0x3E, 0xAF, 0x2F, 0x2F, 0x2F, 0x2F, 0x10,
+    0x29, 0x68, 0x2A, 0x68, 0x2B, 0x32, 0x2C, 0x33, 0x3F, 0x24, 0x4F, 0x3F, 0x50, 0x32, 0x51, 0x25,
+    0x52, 0x26, 0x53, 0x21, 0x65, 0x24, 0x78, 0x63, 0x98, 0x3B, 0xA8, 0x70, 0xBE, 0x3B, 0xCE, 0x70
+};
+
+const unsigned char packed_level_21[] = {
+    0x11, 0x0B, 0x6F, 0x98, 0x58, 0x22, 0x68, 0x21, 0x24, 0x62, 0x27, 0x92, 0x24, 0xF2, 0x70, 0x2A,
+    0x0F, 0xF7, 0x02, 0x06, 0x4C, 0x3B, 0x6A, 0x2A, 0x8A, 0x65, 0x8B, 0x65, 0xA8, 0x70, 0xCE, 0x70
+};
+
+const unsigned char packed_level_22[] = {
+    0x11, 0x0B, 0x4F, 0x7D, 0x51, 0x51, 0x2F, 0x4F, 0x9D, 0x73, 0x2F, 0x15, 0x11, 0x11, 0x11, 0x67,
+    0x61, 0x4F, 0x0E, 0x4C, 0x3B, 0x5C, 0x70, 0x79, 0x3F, 0x7A, 0x64, 0x8C, 0x35, 0x8D, 0x25, 0x8E,
+    0x33, 0x9A, 0x6B, 0x9C, 0x6B, 0x9E, 0x64, 0xA0, 0x64, 0xA1, 0x31, 0xA4, 0x64, 0xB4, 0x21
+};
+
+const unsigned char packed_level_23[] = {
+    0x11, 0x0B, 0x1C, 0x1F, 0x71, 0x13, 0x13, 0x63, 0x17, 0x36, 0x13, 0x13, 0x73, 0x31, 0xB1, 0x13,
+    0x37, 0x16, 0x3A, 0x13, 0xF7, 0x7F, 0x0E, 0x1F, 0x40, 0x50, 0x21, 0x51, 0x32, 0x52, 0x25, 0x53,
+    0x32, 0x54, 0x3F, 0x5C, 0x70, 0x8F, 0x64, 0x91, 0x64, 0xA0, 0x6B, 0xA2, 0x64, 0xA4, 0x64, 0xB5,
+    0x64, 0xB7, 0x64
+};
+
+const unsigned char packed_level_24[] = {
+    0x11, 0x0B, 0x1C, 0x1F, 0xF1, 0x11, 0x1F, 0xF1, 0x11, 0x1F, 0xF1, 0x11, 0x1F, 0xF1, 0x11, 0x1F,
+    0xF1, 0x11, 0x04, 0x02, 0x1F, 0x40, 0xDD, 0x70
+};
+
+const unsigned char packed_level_25[] = {
+    0x11, 0x0B, 0x18, 0x1F, 0xF1, 0x11, 0x1F, 0xF1, 0x11, 0x1F, 0xF1, 0x30, 0x31, 0x3A, 0x31, 0x3A,
+    0x31, 0x0F, 0xF1, 0x11, 0x04, 0x05, 0x1B, 0x40, 0xA0, 0x3F, 0xA4, 0x21, 0xA5, 0x65, 0xDD, 0x70
+};
+
+const unsigned char* const packed_levels[] = {
+    packed_level_1,
+    packed_level_2,
+    packed_level_3,
+    packed_level_4,
+    packed_level_5,
+    packed_level_6,
+    packed_level_7,
+    packed_level_8,
+    packed_level_9,
+    packed_level_10,
+    packed_level_11,
+    packed_level_12,
+    packed_level_13,
+    packed_level_14,
+    packed_level_15,
+    packed_level_16,
+    packed_level_17,
+    packed_level_18,
+    packed_level_19,
+    packed_level_20,
+    packed_level_21,
+    packed_level_22,
+    packed_level_23,
+    packed_level_24,
+    packed_level_25
+};
+
+#define NUM_PACKED_LEVELS 25
+
+#endif // DUPLICATOR_LEVELS_16X16_PACKED_H
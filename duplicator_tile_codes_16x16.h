@@ -0,0 +1,63 @@
+/* duplicator_tile_codes_16x16.h - Tile character to 16x16 screen code table
+ *
+ * GENERATED by tools/gen_tile_tables.js from duplicator_tiles_16x16.h
+ * and duplicator_game.h - do not edit by hand.
+ */
+
+// Include from exactly one source file (duplicator_tile_map_16x16.c)
+#ifndef DUPLICATOR_TILE_CODES_16X16_H
+#define DUPLICATOR_TILE_CODES_16X16_H
+
+// Base screen code (top-left corner) for every tile character; unknown
+// characters map to 0 like empty space
+//   '!' TILE_HOLE_B       0x1C
+//   '$' TILE_WALL_LINE_A  0x54
+//   '%' TILE_WALL_LINE_B  0x58
+//   '&' TILE_WALL_LINE_G  0x5C
+//   '*' TILE_CRATE        0x08
+//   '.' TILE_FLOOR        0x3C
+//   '1' TILE_LINE_A       0x60
+//   '2' TILE_LINE_B       0x64
+//   '3' TILE_LINE_C       0x68
+//   '4' TILE_LINE_D       0x6C
+//   '5' TILE_LINE_E       0x70
+//   '6' TILE_LINE_F       0x74
+//   '7' TILE_LINE_G       0x78
+//   '8' TILE_LINE_H       0x7C
+//   ':' TILE_EXIT_B       0x34
+//   ';' TILE_EXIT_C       0x38
+//   '?' TILE_HOLE_A       0x18
+//   '@' TILE_EXIT_A       0x30
+//   'D' TILE_DOOR_OPEN    0x48
+//   'G' TILE_GATE_A_OPEN  0x40
+//   'H' TILE_GATE_B_OPEN  0x44
+//   '[' TILE_HOLE_A_FILL  0x4C
+//   ']' TILE_HOLE_B_FILL  0x50
+//   'b' TILE_PLATE_A      0x20
+//   'c' TILE_PLATE_B      0x20
+//   'd' TILE_DOOR         0x10
+//   'e' TILE_ENEMY        0x14
+//   'g' TILE_GATE_A       0x28
+//   'h' TILE_GATE_B       0x2C
+//   'k' TILE_KEY          0x0C
+//   'p' TILE_PLAYER       0x04
+const byte tile_screen_codes_16x16[256] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x00
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x10
+    0x00, 0x1C, 0x00, 0x00, 0x54, 0x58, 0x5C, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x3C, 0x00, // 0x20
+    0x00, 0x60, 0x64, 0x68, 0x6C, 0x70, 0x74, 0x78, 0x7C, 0x00, 0x34, 0x38, 0x00, 0x00, 0x00, 0x18, // 0x30
+    0x30, 0x00, 0x00, 0x00, 0x48, 0x00, 0x00, 0x40, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x40
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4C, 0x00, 0x50, 0x00, 0x00, // 0x50
+    0x00, 0x00, 0x20, 0x20, 0x10, 0x14, 0x00, 0x28, 0x2C, 0x00, 0x00, 0x0C, 0x00, 0x00, 0x00, 0x00, // 0x60
+    0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x70
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x80
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x90
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0xA0
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0xB0
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0xC0
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0xD0
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0xE0
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  // 0xF0
+};
+
+#endif // DUPLICATOR_TILE_CODES_16X16_H
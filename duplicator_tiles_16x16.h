@@ -102,5 +102,9 @@ typedef unsigned char byte;
 // Function declaration (implementation in duplicator_tile_map_16x16.c)
 byte map_tile_to_16x16(byte tile);
 
+// The 256-entry lookup table behind map_tile_to_16x16, for hot drawing paths
+// (generated into duplicator_tile_codes_16x16.h by tools/gen_tile_tables.js)
+extern const byte tile_screen_codes_16x16[256];
+
 #endif // DUPLICATOR_TILES_16X16_H
 
@@ -14,12 +14,16 @@ FILES=(
     "duplicator_16x16.c"
     "duplicator_conio_16x16.c"
     "duplicator_conio_16x16.h"
+    "tile_blit_16x16.s"
     "duplicator_tiles_16x16.h"
     "duplicator_tile_map_16x16.c"
+    "duplicator_tile_codes_16x16.h"
     "duplicator_graphics_16x16.h"
     "duplicator_game_16x16.c"
     "duplicator_game.h"
+    "duplicator_tile_props.h"
     "duplicator_levels_16x16.h"
+    "duplicator_levels_16x16_packed.h"
 )
 
 echo "Exporting duplicator 16x16 game files to $OUTPUT_FILE..."
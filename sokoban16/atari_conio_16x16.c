@@ -10,34 +10,7 @@ void my_clrscr_16x16(void) {
     memset(SCREEN_MEM, 0, CHAR_COLS * CHAR_ROWS);
 }
 
-void my_put_tile_16x16(byte tx, byte ty, byte tile_tl) {
-    // Convert tile coordinates to character coordinates
-    byte char_x = tx * 2;
-    byte char_y = ty * 2;
-
-    // Calculate screen memory offsets for all 4 character cells
-    word offset_tl = (word)char_y * CHAR_COLS + char_x;           // Top-left
-    word offset_tr = (word)char_y * CHAR_COLS + char_x + 1;       // Top-right
-    word offset_bl = (word)(char_y + 1) * CHAR_COLS + char_x;     // Bottom-left
-    word offset_br = (word)(char_y + 1) * CHAR_COLS + char_x + 1; // Bottom-right
-
-    // If tile_tl is 0, draw empty space (all spaces)
-    if (tile_tl == 0) {
-        SCREEN_MEM[offset_tl] = 0;  // Space
-        SCREEN_MEM[offset_tr] = 0;  // Space
-        SCREEN_MEM[offset_bl] = 0;  // Space
-        SCREEN_MEM[offset_br] = 0;  // Space
-    } else {
-        // Write all 4 characters that make up the tile
-        // tile_tl is the base tile code (e.g., TILE_WALL)
-        // The 4 corners are: tile_tl+TILE_TL, +TILE_TR, +TILE_BL, +TILE_BR
-        // Since TILE_TL=0, TILE_TR=1, TILE_BL=2, TILE_BR=3, this simplifies to:
-        SCREEN_MEM[offset_tl] = tile_tl + TILE_TL;  // Top-left (tile_tl+0)
-        SCREEN_MEM[offset_tr] = tile_tl + TILE_TR;  // Top-right (tile_tl+1)
-        SCREEN_MEM[offset_bl] = tile_tl + TILE_BL;  // Bottom-left (tile_tl+2)
-        SCREEN_MEM[offset_br] = tile_tl + TILE_BR;  // Bottom-right (tile_tl+3)
-    }
-}
+// my_put_tile_16x16 is implemented in tile_blit_16x16.s
 
 void my_cputsxy_16x16(byte x, byte y, const char* str) {
     word offset = (word)y * CHAR_COLS + x;
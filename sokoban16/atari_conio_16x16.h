@@ -47,8 +47,10 @@ void my_clrscr_16x16(void);
   
   Note: The function assumes tiles use 4 consecutive characters:
   tile_tl, tile_tl+1, tile_tl+2, tile_tl+3
+
+  Implemented in tile_blit_16x16.s
 */
-void my_put_tile_16x16(byte tx, byte ty, byte tile_tl);
+void __fastcall__ my_put_tile_16x16(byte tx, byte ty, byte tile_tl);
 
 /*
   Put a string of text at character position (for status line, etc.)
@@ -1,5 +1,6 @@
 // Link the 16x16 mode libraries
 //#link "atari_conio_16x16.c"
+//#link "tile_blit_16x16.s"
 //#link "atari_font_16x16.c"
 //#link "sokoban_game_16x16.c"
 
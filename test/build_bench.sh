@@ -0,0 +1,39 @@
+#!/bin/bash
+# Build and run the 6502 cycle benchmark for the duplicator engine
+# Needs cc65 2.20 or newer (cl65 and sim65 on the PATH)
+# Usage: ./build_bench.sh [--random]
+#   --random  Time random moves instead of the level solutions
+
+set -e  # Exit on error
+
+CL65=${CL65:-cl65}
+SIM65=${SIM65:-sim65}
+CFLAGS=${CFLAGS:-"-Oirs"}
+OUTPUT="duplicator_bench.prg"
+MODE=""
+
+if [ "$1" = "--random" ]; then
+    MODE="-DBENCH_RANDOM"
+fi
+
+echo "========================================"
+echo "Building Duplicator Engine Benchmark"
+echo "========================================"
+
+# Game sources live one level up; duplicator8/ provides atari_conio.h,
+# which test_conio.c implements. ENGINE_PROFILE enables the stage hooks;
+# the load columns time both level loaders, which cc65 builds leave out
+# one of by default.
+cd "$(dirname "$0")"
+SRC_DIR=..
+
+$CL65 -t sim6502 $CFLAGS -DENGINE_PROFILE $MODE \
+    -DENGINE_LEVEL_STRINGS -DENGINE_LEVEL_PACKED \
+    -I. -I$SRC_DIR -I$SRC_DIR/duplicator8 \
+    -o $OUTPUT \
+    duplicator_bench.c \
+    test_conio.c \
+    $SRC_DIR/duplicator_game.c
+
+echo ""
+$SIM65 $OUTPUT
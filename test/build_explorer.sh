@@ -0,0 +1,30 @@
+#!/bin/bash
+# Build script for the worst-turn explorer (host tool)
+# Searches every level for the turns that do the most engine work
+
+set -e  # Exit on error
+
+CC=gcc
+CFLAGS="-Wall -Wextra -g -O2 -std=c99"
+OUTPUT="duplicator_explorer"
+
+echo "========================================"
+echo "Building Duplicator Worst-Turn Explorer"
+echo "========================================"
+
+# Game sources live one level up; duplicator8/ provides atari_conio.h
+# ENGINE_COUNTERS enables the engine work counters, ENGINE_REENTRANT the
+# engine_* API on the tool's own context
+cd "$(dirname "$0")"
+SRC_DIR=..
+
+$CC $CFLAGS -DENGINE_COUNTERS -DENGINE_REENTRANT \
+    -I. -I$SRC_DIR -I$SRC_DIR/duplicator8 \
+    -include test_conio.h \
+    -o $OUTPUT \
+    test_conio.c \
+    $SRC_DIR/duplicator_game.c \
+    duplicator_explorer.c
+
+echo ""
+echo "Run: ./$OUTPUT --help"
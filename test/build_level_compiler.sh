@@ -0,0 +1,29 @@
+#!/bin/bash
+# Build script for the level compiler (host tool)
+# Packs duplicator_levels_16x16.h into duplicator_levels_16x16_packed.h
+
+set -e  # Exit on error
+
+CC=gcc
+CFLAGS="-Wall -Wextra -g -O2 -std=c99"
+OUTPUT="level_compiler"
+
+echo "========================================"
+echo "Building Level Compiler"
+echo "========================================"
+
+# Game sources live one level up; duplicator8/ provides atari_conio.h
+# ENGINE_REENTRANT gives the engine_* API the packed levels are checked with
+cd "$(dirname "$0")"
+SRC_DIR=..
+
+$CC $CFLAGS -DENGINE_REENTRANT \
+    -I. -I$SRC_DIR -I$SRC_DIR/duplicator8 \
+    -include test_conio.h \
+    -o $OUTPUT \
+    test_conio.c \
+    $SRC_DIR/duplicator_game.c \
+    level_compiler.c
+
+echo ""
+./$OUTPUT --output $SRC_DIR/duplicator_levels_16x16_packed.h
@@ -0,0 +1,31 @@
+#!/bin/bash
+# Build script for the replay runner (host tool)
+# Records and verifies packed replays (2 bits per move) against the engine
+
+set -e  # Exit on error
+
+CC=gcc
+CFLAGS="-Wall -Wextra -g -O2 -std=c99 -D_POSIX_C_SOURCE=199309L"
+OUTPUT="replay_runner"
+
+echo "========================================"
+echo "Building Replay Runner"
+echo "========================================"
+
+# Game sources live one level up; duplicator8/ provides atari_conio.h
+# ENGINE_HASH gives the state hash the replays are checked against,
+# ENGINE_REENTRANT the engine_* API on the tool's own context
+cd "$(dirname "$0")"
+SRC_DIR=..
+
+$CC $CFLAGS -DENGINE_REENTRANT -DENGINE_HASH \
+    -I. -I$SRC_DIR -I$SRC_DIR/duplicator8 \
+    -include test_conio.h \
+    -o $OUTPUT \
+    test_conio.c \
+    $SRC_DIR/duplicator_game.c \
+    replay_format.c \
+    replay_runner.c
+
+echo ""
+echo "Run: ./$OUTPUT --help"
@@ -0,0 +1,25 @@
+#!/bin/bash
+# Build script for the Sokoban solver (host tool)
+# Push-optimal A* solver for the levels shipped with the Sokoban games
+
+set -e  # Exit on error
+
+CC=gcc
+CFLAGS="-Wall -Wextra -g -O2 -std=c99 -D_POSIX_C_SOURCE=199309L"
+OUTPUT="sokoban_solver"
+
+echo "========================================"
+echo "Building Sokoban Solver"
+echo "========================================"
+
+# sokoban8/ provides the tile characters load_level reads (sokoban_game.h)
+cd "$(dirname "$0")"
+SRC_DIR=..
+
+$CC $CFLAGS \
+    -I$SRC_DIR/sokoban8 \
+    -o $OUTPUT \
+    sokoban_solver.c
+
+echo ""
+echo "Run: ./$OUTPUT --help"
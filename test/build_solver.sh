@@ -0,0 +1,29 @@
+#!/bin/bash
+# Build script for the optimal solver (host tool)
+# Multithreaded breadth-first search for the shortest solution of every level
+
+set -e  # Exit on error
+
+CC=gcc
+CFLAGS="-Wall -Wextra -g -O2 -std=c11 -pthread -D_POSIX_C_SOURCE=199309L"
+OUTPUT="duplicator_solver"
+
+echo "========================================"
+echo "Building Duplicator Solver"
+echo "========================================"
+
+# Game sources live one level up; duplicator8/ provides atari_conio.h
+# ENGINE_REENTRANT gives the solver the engine_* API on its own contexts
+cd "$(dirname "$0")"
+SRC_DIR=..
+
+$CC $CFLAGS -DENGINE_REENTRANT \
+    -I. -I$SRC_DIR -I$SRC_DIR/duplicator8 \
+    -include test_conio.h \
+    -o $OUTPUT \
+    test_conio.c \
+    $SRC_DIR/duplicator_game.c \
+    duplicator_solver.c
+
+echo ""
+echo "Run: ./$OUTPUT --help"
@@ -12,13 +12,22 @@ echo "========================================"
 echo "Building Duplicator Game Test Suite"
 echo "========================================"
 
+# Game sources live one level up; duplicator8/ provides atari_conio.h
+cd "$(dirname "$0")"
+SRC_DIR=..
+
 # Compile with -include to force test_conio.h to be included before atari_conio.h
 # This allows us to use the test version without modifying duplicator_game.c
-$CC $CFLAGS \
+# ENGINE_REENTRANT adds the engine_* context API (the plain API still works)
+# ENGINE_HASH adds the incremental board hash (get_state_hash)
+# ENGINE_UNDO adds the undo timeline (undo_turn, redo_turn)
+$CC $CFLAGS -DENGINE_REENTRANT -DENGINE_HASH -DENGINE_UNDO \
+    -I. -I$SRC_DIR -I$SRC_DIR/duplicator8 \
     -include test_conio.h \
     -o $OUTPUT \
     test_conio.c \
-    duplicator_game.c \
+    $SRC_DIR/duplicator_game.c \
+    replay_format.c \
     duplicator_test_runner.c
 
 if [ $? -eq 0 ]; then
@@ -0,0 +1,36 @@
+#!/bin/bash
+# Build script for the level validator (host tool)
+# Solves every shipped level pack with both solvers and writes a CSV report
+
+set -e  # Exit on error
+
+CC=gcc
+CFLAGS="-Wall -Wextra -g -O2 -std=c11 -pthread -D_POSIX_C_SOURCE=199309L -DSOLVER_LIBRARY"
+OUTPUT="level_validator"
+
+echo "========================================"
+echo "Building Level Validator"
+echo "========================================"
+
+# The solvers are linked in without their main()
+# sokoban_solver.c is compiled on its own: sokoban8/ and duplicator8/
+# both have a game header, and each solver needs its own
+cd "$(dirname "$0")"
+SRC_DIR=..
+
+$CC $CFLAGS -I$SRC_DIR/sokoban8 -c -o sokoban_solver.o sokoban_solver.c
+
+$CC $CFLAGS -DENGINE_REENTRANT \
+    -I. -I$SRC_DIR -I$SRC_DIR/duplicator8 \
+    -include test_conio.h \
+    -o $OUTPUT \
+    test_conio.c \
+    $SRC_DIR/duplicator_game.c \
+    duplicator_solver.c \
+    level_validator.c \
+    sokoban_solver.o
+
+rm -f sokoban_solver.o
+
+echo ""
+echo "Run: ./$OUTPUT --help"
@@ -0,0 +1,254 @@
+/*
+  duplicator_bench.c - 6502 cycle benchmark for the duplicator engine
+
+  Built with cc65 for the sim65 simulator (see build_bench.sh). For every
+  shipped level it loads the level, then plays its shortest solution
+  from duplicator_solutions_16x16.h and reports the CPU cycles each turn
+  costs, broken down by engine stage (the ENGINE_STAGE hooks in
+  try_move_player) plus the flush_dirty_cells redraw. Solutions are real
+  play: every turn moves something, and the pushes, duplications and
+  enemy chases a level is built around all happen. Levels without a
+  solution are skipped. Built with BENCH_RANDOM it replays a fixed
+  pseudo-random move sequence on every level instead, which also covers
+  the unsolvable levels but times many moves into walls.
+
+  The load columns compare load_level on the row strings with
+  load_packed_level on the compiled levels of
+  duplicator_levels_16x16_packed.h (see level_compiler.c).
+
+  Cycles are read from the sim65 counter peripheral, so this only runs
+  under sim65 from cc65 2.20 or newer.
+*/
+
+#include "duplicator_game.h"
+#include "duplicator_levels_16x16.h"
+#include "duplicator_levels_16x16_packed.h"
+#include "duplicator_solutions_16x16.h"
+#include <stdio.h>
+#include <string.h>
+
+// sim65 counter peripheral (same layout as <sim65.h>)
+#define SIM65_COUNTER_LATCH  (*(volatile byte*)0xFFC0)  // Write to latch all counters
+#define SIM65_COUNTER_SELECT (*(volatile byte*)0xFFC1)  // Counter shown at VALUE
+#define SIM65_COUNTER_VALUE  ((volatile byte*)0xFFC2)   // 64-bit little endian
+#define SIM65_CLOCK_CYCLES   0x00
+
+#ifdef BENCH_RANDOM
+// Turns replayed per level
+#define BENCH_TURNS 64
+#endif
+
+// CPU cycles in one NTSC frame; a turn plus its flush should fit in one
+#define FRAME_CYCLES 29868UL
+
+// Stage columns: engine stages, then the redraw
+#define STAGE_FLUSH   STAGE_END
+#define BENCH_COLUMNS (STAGE_FLUSH + 1)
+
+static const char* column_names[BENCH_COLUMNS] = {
+    "undo", "players", "dup", "gates", "enemies", "flush"
+};
+
+// Cycles spent reading the counter, removed from every measurement
+static unsigned long timer_overhead;
+
+// Stage currently being timed and when it started
+static byte current_stage;
+static unsigned long stage_start;
+
+// Cycles per column for the turn being measured
+static unsigned long turn_cycles[BENCH_COLUMNS];
+
+// Per-level totals and maximums
+static unsigned long level_cycles[BENCH_COLUMNS];
+static unsigned long level_max[BENCH_COLUMNS];
+
+#ifdef BENCH_RANDOM
+// Move generator state (fixed seed per level, so every run is identical)
+static word rng;
+#else
+// Rest of the solution being played
+static const char* solution;
+#endif
+
+static unsigned long read_cycles(void) {
+    volatile byte* value = SIM65_COUNTER_VALUE;
+
+    SIM65_COUNTER_LATCH = 0;
+    return (unsigned long)value[0]
+        | ((unsigned long)value[1] << 8)
+        | ((unsigned long)value[2] << 16)
+        | ((unsigned long)value[3] << 24);
+}
+
+static unsigned long cycles_since(unsigned long start) {
+    unsigned long elapsed = read_cycles() - start;
+    return elapsed > timer_overhead ? elapsed - timer_overhead : 0;
+}
+
+// Called by try_move_player as each stage starts (ENGINE_PROFILE build)
+void engine_stage(byte stage) {
+    if (current_stage < STAGE_END) {
+        turn_cycles[current_stage] += cycles_since(stage_start);
+    }
+    current_stage = stage;
+    stage_start = read_cycles();
+}
+
+static byte next_move(void) {
+#ifdef BENCH_RANDOM
+    // 16-bit xorshift
+    rng ^= rng << 7;
+    rng ^= rng >> 9;
+    rng ^= rng << 8;
+    return (byte)(rng & 3);
+#else
+    switch (*solution++) {
+        case 'u': return 0;
+        case 'd': return 1;
+        case 'l': return 2;
+        default: return 3;
+    }
+#endif
+}
+
+static void play_move(byte move) {
+    switch (move) {
+        case 0: try_move_player(0, -1); break;
+        case 1: try_move_player(0, 1); break;
+        case 2: try_move_player(-1, 0); break;
+        default: try_move_player(1, 0); break;
+    }
+}
+
+static unsigned long bench_load(byte level) {
+    unsigned long start = read_cycles();
+
+    load_level(levels[level], MAX_LEVEL_HEIGHT);
+    draw_level();
+    return cycles_since(start);
+}
+
+static unsigned long bench_unpack(byte level) {
+    unsigned long start = read_cycles();
+
+    load_packed_level(packed_levels[level]);
+    draw_level();
+    return cycles_since(start);
+}
+
+// Replay the moves of a level; returns the worst turn and sets *turns to
+// the number of turns played
+static unsigned long bench_level(byte level, byte* turns, byte* over_budget) {
+    unsigned long turn_total, worst = 0;
+    unsigned long start;
+    byte turn, col;
+
+    memset(level_cycles, 0, sizeof(level_cycles));
+    memset(level_max, 0, sizeof(level_max));
+    *over_budget = 0;
+#ifdef BENCH_RANDOM
+    rng = 0x1234 + level;
+    *turns = BENCH_TURNS;
+#else
+    solution = level_solutions[level];
+    *turns = (byte)strlen(solution);
+#endif
+
+    for (turn = 0; turn < *turns; turn++) {
+#ifdef BENCH_RANDOM
+        // Restart when the level was won or lost, like the game does
+        if (is_level_complete() || get_game_state()->num_players == 0) {
+            bench_load(level);
+        }
+#endif
+
+        memset(turn_cycles, 0, sizeof(turn_cycles));
+        current_stage = STAGE_END;
+        play_move(next_move());
+
+        start = read_cycles();
+        wait_vblank();
+        flush_dirty_cells();
+        turn_cycles[STAGE_FLUSH] = cycles_since(start);
+
+        turn_total = 0;
+        for (col = 0; col < BENCH_COLUMNS; col++) {
+            level_cycles[col] += turn_cycles[col];
+            if (turn_cycles[col] > level_max[col]) {
+                level_max[col] = turn_cycles[col];
+            }
+            turn_total += turn_cycles[col];
+        }
+        if (turn_total > worst) {
+            worst = turn_total;
+        }
+        if (turn_total > FRAME_CYCLES) {
+            (*over_budget)++;
+        }
+    }
+    return worst;
+}
+
+int main(void) {
+    unsigned long load, unpack, worst, total;
+    unsigned long all_worst = 0;
+    unsigned int all_over = 0, all_turns = 0;
+    byte turns, over_budget;
+    byte level, col;
+
+    SIM65_COUNTER_SELECT = SIM65_CLOCK_CYCLES;
+    stage_start = read_cycles();
+    timer_overhead = read_cycles() - stage_start;
+
+#ifdef BENCH_RANDOM
+    printf("Duplicator engine benchmark: %u random turns/level, budget %lu cycles/turn\n",
+           BENCH_TURNS, FRAME_CYCLES);
+#else
+    printf("Duplicator engine benchmark: level solutions, budget %lu cycles/turn\n",
+           FRAME_CYCLES);
+#endif
+    printf("Average cycles per turn (max in brackets)\n\n");
+    printf("lvl   load unpack");
+    for (col = 0; col < BENCH_COLUMNS; col++) {
+        printf(" %13s", column_names[col]);
+    }
+    printf("         total over turns\n");
+
+    for (level = 0; level < NUM_LEVELS; level++) {
+        unpack = bench_unpack(level);
+        load = bench_load(level);
+        printf("%3u %6lu %6lu", level + 1, load, unpack);
+#ifndef BENCH_RANDOM
+        if (level_solutions[level] == NULL) {
+            printf("  no solution, skipped\n");
+            continue;
+        }
+#endif
+        worst = bench_level(level, &turns, &over_budget);
+
+        total = 0;
+        for (col = 0; col < BENCH_COLUMNS; col++) {
+            printf(" %5lu (%5lu)", level_cycles[col] / turns, level_max[col]);
+            total += level_cycles[col];
+        }
+        printf(" %5lu (%5lu) %4u %5u", total / turns, worst, over_budget, turns);
+#ifndef BENCH_RANDOM
+        // The timings only mean real play if the solution still wins
+        if (is_level_complete() != 1) {
+            printf("  solution failed");
+        }
+#endif
+        printf("\n");
+
+        if (worst > all_worst) {
+            all_worst = worst;
+        }
+        all_over += over_budget;
+        all_turns += turns;
+    }
+
+    printf("\nWorst turn: %lu cycles (%lu%% of budget), %u of %u turns over budget\n",
+           all_worst, all_worst * 100 / FRAME_CYCLES, all_over, all_turns);
+    return 0;
+}
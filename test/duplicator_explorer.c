@@ -0,0 +1,221 @@
+/*
+  duplicator_explorer.c - Search for the most expensive turns in each level
+
+  Average turn cost doesn't tell us whether a turn can blow the frame
+  budget; the single worst turn does. This host tool drives the engine
+  through random walks and greedy walks (each step picks the move whose
+  turn does the most work) over every level in duplicator_levels_16x16.h,
+  measures each turn with the engine work counters (ENGINE_COUNTERS) and
+  prints the top-N costliest turns with the moves that reach them.
+
+  The moves use the same letters as execute_moves() in the test runner,
+  so a reported turn can be replayed there (or in duplicator_bench.c);
+  the last move is the expensive turn.
+
+  Usage: ./duplicator_explorer [--level N] [--top N] [--walks N]
+                               [--length N] [--seed N]
+*/
+
+#include "duplicator_game.h"
+#include "duplicator_levels_16x16.h"
+#include "test_conio.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#define MAX_TOP        64
+#define MAX_WALK       128   // Longest move sequence
+
+static const char move_letters[4] = { 'u', 'd', 'l', 'r' };
+
+// One measured turn
+typedef struct {
+    byte level;                  // 0-based level index
+    unsigned int cost;           // Sum of the work counters
+    EngineCounters counters;
+    byte players;                // Players on the board after the turn
+    char moves[MAX_WALK + 1];    // Moves from level start, ending with this turn
+} TurnRecord;
+
+// Game being explored (its own context, so the tool could run several)
+static EngineContext game;
+
+static TurnRecord top[MAX_TOP];
+static int num_top;
+static int top_size = 10;
+
+// Search settings
+static int walks = 200;
+static int walk_length = 40;
+static uint32_t rng_state = 1;
+
+static uint32_t next_random(void) {
+    // xorshift32
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static unsigned int turn_cost(const EngineCounters* counters) {
+    return counters->cells_scanned + counters->entities_touched + counters->tiles_drawn;
+}
+
+static void play_move(char move) {
+    switch (move) {
+        case 'u': engine_try_move_player(&game, 0, -1); break;
+        case 'd': engine_try_move_player(&game, 0, 1); break;
+        case 'l': engine_try_move_player(&game, -1, 0); break;
+        default: engine_try_move_player(&game, 1, 0); break;
+    }
+}
+
+// Reload a level and replay moves without measuring or drawing them
+static void replay(byte level, const char* moves, int length) {
+    int i;
+
+    engine_set_render_enabled(&game, 0);
+    engine_load_level(&game, levels[level], MAX_LEVEL_HEIGHT);
+    for (i = 0; i < length; i++) {
+        play_move(moves[i]);
+    }
+    engine_set_render_enabled(&game, 1);
+}
+
+// Play one measured turn
+static unsigned int measure_move(char move) {
+    memset(&game.counters, 0, sizeof(game.counters));
+    play_move(move);
+    engine_flush_dirty_cells(&game);
+    return turn_cost(&game.counters);
+}
+
+static byte level_over(void) {
+    return game.game_state.level_complete || game.game_state.num_players == 0;
+}
+
+// Keep the turn if it is among the top-N (ignoring exact repeats)
+static void record_turn(byte level, const char* moves, int length) {
+    unsigned int cost = turn_cost(&game.counters);
+    int i, pos;
+
+    if (num_top == top_size && cost <= top[num_top - 1].cost) {
+        return;
+    }
+    for (i = 0; i < num_top; i++) {
+        if (top[i].level == level && (int)strlen(top[i].moves) == length
+                && memcmp(top[i].moves, moves, length) == 0) {
+            return;
+        }
+    }
+
+    pos = num_top < top_size ? num_top++ : num_top - 1;
+    while (pos > 0 && top[pos - 1].cost < cost) {
+        top[pos] = top[pos - 1];
+        pos--;
+    }
+    top[pos].level = level;
+    top[pos].cost = cost;
+    top[pos].counters = game.counters;
+    top[pos].players = game.game_state.num_players;
+    memcpy(top[pos].moves, moves, length);
+    top[pos].moves[length] = '\0';
+}
+
+// Random walk from the level start, recording every turn
+static void random_walk(byte level) {
+    char moves[MAX_WALK];
+    int length;
+
+    replay(level, moves, 0);
+    for (length = 0; length < walk_length && !level_over(); length++) {
+        moves[length] = move_letters[next_random() & 3];
+        measure_move(moves[length]);
+        record_turn(level, moves, length + 1);
+    }
+}
+
+// Greedy walk: try all 4 moves from the current position and keep the
+// most expensive one (ties and 1 step in 8 are random, so walks differ)
+static void greedy_walk(byte level) {
+    char moves[MAX_WALK];
+    int length, d;
+    unsigned int cost, best_cost;
+    char best;
+
+    replay(level, moves, 0);
+    for (length = 0; length < walk_length && !level_over(); length++) {
+        best = move_letters[next_random() & 3];
+        best_cost = 0;
+
+        for (d = 0; d < 4; d++) {
+            replay(level, moves, length);
+            moves[length] = move_letters[d];
+            cost = measure_move(moves[length]);
+            record_turn(level, moves, length + 1);
+            if (cost > best_cost || (cost == best_cost && (next_random() & 1))) {
+                best_cost = cost;
+                best = moves[length];
+            }
+        }
+        if ((next_random() & 7) == 0) {
+            best = move_letters[next_random() & 3];
+        }
+
+        moves[length] = best;
+        replay(level, moves, length + 1);
+    }
+}
+
+static void print_usage(const char* name) {
+    printf("Usage: %s [--level N] [--top N] [--walks N] [--length N] [--seed N]\n", name);
+    printf("  --level N   Only search level N (1-%d, default all)\n", NUM_LEVELS);
+    printf("  --top N     Number of turns to report (default 10, max %d)\n", MAX_TOP);
+    printf("  --walks N   Random and greedy walks per level (default 200)\n");
+    printf("  --length N  Moves per walk (default 40, max %d)\n", MAX_WALK);
+    printf("  --seed N    Random seed (default 1)\n");
+}
+
+int main(int argc, char* argv[]) {
+    int first_level = 0, last_level = NUM_LEVELS - 1;
+    int i, level, walk;
+
+    for (i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--level") == 0) {
+            first_level = last_level = atoi(argv[++i]) - 1;
+        } else if (i + 1 < argc && strcmp(argv[i], "--top") == 0) {
+            top_size = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--walks") == 0) {
+            walks = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--length") == 0) {
+            walk_length = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--seed") == 0) {
+            rng_state = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (first_level < 0 || first_level >= NUM_LEVELS || top_size < 1 || top_size > MAX_TOP
+            || walk_length < 1 || walk_length > MAX_WALK || walks < 0 || rng_state == 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    for (level = first_level; level <= last_level; level++) {
+        for (walk = 0; walk < walks; walk++) {
+            random_walk((byte)level);
+            greedy_walk((byte)level);
+        }
+    }
+
+    printf("Costliest turns (cost = cells scanned + entities touched + tiles drawn)\n\n");
+    printf("rank level  cost cells entities tiles players  moves\n");
+    for (i = 0; i < num_top; i++) {
+        printf("%4d %5d %5u %5u %8u %5u %7u  %s\n", i + 1, top[i].level + 1, top[i].cost,
+               top[i].counters.cells_scanned, top[i].counters.entities_touched,
+               top[i].counters.tiles_drawn, top[i].players, top[i].moves);
+    }
+    return 0;
+}
@@ -0,0 +1,43 @@
+/*
+  Duplicator Game - Shortest Solutions of the 16x16 Levels
+
+  Move strings printed by test/duplicator_solver.c (the letters used by
+  execute_moves()); NULL marks a level the solver reports unsolvable
+  under the current engine rules. Copy them in again after a rule or
+  level change. duplicator_bench.c replays them to time real play.
+*/
+
+#ifndef DUPLICATOR_SOLUTIONS_16X16_H
+#define DUPLICATOR_SOLUTIONS_16X16_H
+
+#include <stddef.h>
+
+const char* level_solutions[] = {
+    "uuuuuuu",  // level_1
+    "uulullluuuurl",  // level_2
+    "rrrruuuurl",  // level_3
+    "rrrruuuurl",  // level_4
+    "rruurrl",  // level_5
+    "uuuuuururrrdddu",  // level_6
+    "uuuururl",  // level_7
+    "uuurl",  // level_8
+    NULL,  // level_9
+    "rrrrrrrrrl",  // level_10
+    "rddrrrl",  // level_11
+    "uuurrrrrrurdrrlr",  // level_12
+    "rrdrdruuuudddrrrrudlr",  // level_13
+    "uulrl",  // level_14
+    NULL,  // level_15
+    "rrrdrl",  // level_16
+    NULL,  // level_17
+    "rrrrrrrrrdu",  // level_18
+    "uuulllr",  // level_19
+    "llllllllllllllll",  // level_20
+    "lllllluuuuurdddddruluuuullulllddlldllluul",  // level_21
+    "llllllllllllllll",  // level_22
+    "lllluuu",  // level_23
+    "uuuuuuuuuu",  // level_24
+    "uuuuuuuuuu",  // level_25
+};
+
+#endif // DUPLICATOR_SOLUTIONS_16X16_H
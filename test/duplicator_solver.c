@@ -0,0 +1,975 @@
+/*
+  duplicator_solver.c - Breadth-first optimal solver for Duplicator levels
+
+  Runs the real engine headless on its own EngineContexts and searches
+  every level in duplicator_levels_16x16.h breadth first, so the first
+  solution found is a shortest one.
+
+  States are stored packed (see encode_state): the entities in a
+  canonical order with a 2-bit type and a "was on a hole" bit each, one
+  bit per door (still closed) and per gate (open), and the gate and hole
+  flags. Everything else in the level map follows from the level itself.
+  The engine only reads slot order among players and among enemies
+  (enemies move in slot order and chase the first player they see), so
+  the packing lists players, then enemies, each in table order, then
+  crates and keys by cell. Once no enemy is left (none can appear after
+  that) players are listed by cell too. Positions that differ only in
+  the order of crates and keys, or of players with no enemy around, are
+  searched once. Frontier states are unpacked into a context with the
+  entities in that order before they are expanded. Visited states are
+  kept as their packed bytes next to a 64-bit hash, and a hash match only
+  counts once the bytes compare equal. Every solution is still replayed
+  on a context loaded the normal way before it is reported.
+
+  The search runs one BFS layer at a time on --threads worker threads:
+  - The frontier is cut into chunks and each thread gets a deque of
+    chunks; it pops its own from the bottom and, when it runs dry, steals
+    from the top of another thread's deque
+  - The visited set is split into shards of open-addressing hash slots
+    claimed with compare-and-swap, so threads never lock to deduplicate
+  - Children go to per-thread buffers that become the next frontier
+  Shards and the node table are grown between layers (when no thread is
+  running) to hold the most states the next layer can add.
+
+  For each level it prints the optimal move string (the letters used by
+  execute_moves() in the test runner), or that the level is unsolvable or
+  hit the state limit, with the number of states explored per second.
+  With several threads a different solution of the same length may be
+  reported from run to run.
+
+  Usage: ./duplicator_solver [--level N] [--max-states N] [--threads N]
+                             [--check]
+
+  Built with SOLVER_LIBRARY, main() is left out and duplicator_solve()
+  (level_solvers.h) solves any level with a time and memory budget.
+*/
+
+#include "duplicator_game.h"
+#include "duplicator_levels_16x16.h"
+#include "test_conio.h"
+#include "level_solvers.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+
+// Moves in the order they are tried (and their letters)
+static const signed char move_dx[4] = { 0, 0, -1, 1 };
+static const signed char move_dy[4] = { -1, 1, 0, 0 };
+static const char move_letters[4] = { 'u', 'd', 'l', 'r' };
+
+#define MAX_THREADS  64
+#define SHARD_BITS   6
+#define NUM_SHARDS   (1 << SHARD_BITS)
+#define MAX_CHUNK    256        // Frontier states per work item
+#define NO_PARENT    UINT32_MAX
+
+// Packed state: entity count, then per entity cell (8 bits), type
+// (2 bits) and prev_under-is-a-hole (1 bit), then the door and gate bits
+// and 5 flag bits
+#define PACKED_BITS  (8 + MAX_ENTITIES * 11 + MAX_DOORS + MAX_GATES + 5)
+#define PACKED_BYTES ((PACKED_BITS + 7) / 8)
+
+// Entity types by their 2-bit code
+static const char entity_types[4] = { TILE_PLAYER, TILE_CRATE, TILE_KEY, TILE_ENEMY };
+
+// Search tree node: how the state was reached
+typedef struct {
+    uint32_t parent;
+    char move;
+} Node;
+
+typedef struct {
+    byte bytes[PACKED_BYTES];
+} PackedState;
+
+// State waiting to be expanded
+typedef struct {
+    PackedState state;
+    uint32_t node;
+} FrontierEntry;
+
+// Growable array of FrontierEntry
+typedef struct {
+    FrontierEntry* items;
+    size_t count;
+    size_t capacity;
+} Frontier;
+
+// Visited state: its hash (SLOT_EMPTY, SLOT_BUSY while the claiming
+// thread copies the state in, then the hash) and its packed bytes
+#define SLOT_EMPTY 0
+#define SLOT_BUSY  1
+
+typedef struct {
+    _Atomic uint64_t hash;
+    PackedState state;
+} Slot;
+
+// One shard of the visited set
+typedef struct {
+    Slot* slots;
+    size_t capacity;            // Power of two
+    atomic_size_t count;
+} Shard;
+
+// Chunks of the current frontier owned by one thread; the owner takes
+// from the bottom, thieves from the top
+typedef struct {
+    size_t* chunks;
+    size_t top;
+    size_t bottom;
+    pthread_mutex_t lock;
+} Deque;
+
+// Per-thread counters (for one level and for the whole run)
+typedef struct {
+    size_t expanded;            // States whose moves were tried
+    size_t generated;           // New states added to the next frontier
+    size_t duplicates;          // Children already visited
+    size_t steals;              // Chunks taken from other threads
+    double busy;                // Seconds spent expanding
+} ThreadStats;
+
+typedef struct {
+    int id;
+    Frontier next;
+    Deque deque;
+    ThreadStats level;
+    ThreadStats total;
+} Worker;
+
+static Node* nodes;
+static size_t nodes_capacity;
+static atomic_size_t num_nodes;
+
+static Shard shards[NUM_SHARDS];
+
+static Worker workers[MAX_THREADS];
+static int num_threads = 1;
+
+// Layer being expanded
+static Frontier current;
+static size_t chunk_size;
+static size_t num_chunks;
+
+// Set by the first thread to reach the exit
+static _Atomic uint32_t goal_node;
+
+static size_t max_states = 20000000;
+static double max_seconds;              // 0 = no limit
+static size_t max_bytes;                // 0 = no limit
+static int check_encoding;
+
+// Level being solved as load_level leaves it, and its map without the
+// entities, doors and gates (the part of a state that never changes)
+static EngineContext level_start;
+static char static_map[MAP_CELLS];
+
+static void* checked_realloc(void* ptr, size_t size) {
+    void* result = realloc(ptr, size);
+    if (result == NULL && size != 0) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return result;
+}
+
+static double seconds_now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+// FNV-1a over a block of bytes
+static uint64_t hash_bytes(uint64_t hash, const void* data, size_t length) {
+    const byte* p = (const byte*)data;
+
+    while (length--) {
+        hash ^= *p++;
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+// Append the low 'bits' bits of value to a packed state
+static void put_bits(PackedState* p, size_t* pos, unsigned value, byte bits) {
+    while (bits--) {
+        if (value & 1) {
+            p->bytes[*pos >> 3] |= (byte)(1 << (*pos & 7));
+        }
+        value >>= 1;
+        (*pos)++;
+    }
+}
+
+static unsigned get_bits(const PackedState* p, size_t* pos, byte bits) {
+    unsigned value = 0;
+    byte i;
+
+    for (i = 0; i < bits; i++, (*pos)++) {
+        if (p->bytes[*pos >> 3] & (1 << (*pos & 7))) {
+            value |= 1u << i;
+        }
+    }
+    return value;
+}
+
+static byte entity_code(char type) {
+    byte code = 0;
+
+    while (code < 3 && entity_types[code] != type) {
+        code++;
+    }
+    return code;
+}
+
+static byte is_open_gate(char tile) {
+    return tile == TILE_GATE_A_OPEN || tile == TILE_GATE_B_OPEN;
+}
+
+// Canonical entity order: players, enemies, then crates and keys. Players
+// and enemies keep their table order, which the engine depends on;
+// crates and keys are sorted by cell, and so are players when there is
+// no enemy to chase them.
+static void canonical_order(const GameState* s, byte* order) {
+    unsigned key[MAX_ENTITIES];
+    byte i, j, k, enemies = 0;
+
+    for (i = 0; i < s->num_entities; i++) {
+        enemies += s->type[i] == TILE_ENEMY;
+    }
+    for (i = 0; i < s->num_entities; i++) {
+        if (s->type[i] == TILE_PLAYER) {
+            key[i] = enemies ? i : s->cell[i];
+        } else if (s->type[i] == TILE_ENEMY) {
+            key[i] = 0x100 + i;
+        } else {
+            key[i] = 0x200 + s->cell[i];
+        }
+    }
+    for (i = 0; i < s->num_entities; i++) {
+        k = i;
+        for (j = i; j > 0 && key[order[j - 1]] > key[k]; j--) {
+            order[j] = order[j - 1];
+        }
+        order[j] = k;
+    }
+}
+
+// Pack a context, entities in canonical order
+static void encode_state(const EngineContext* c, PackedState* out) {
+    const GameState* s = &c->game_state;
+    byte order[MAX_ENTITIES];
+    byte i, k, cell;
+    char tile;
+    size_t pos = 0;
+
+    canonical_order(s, order);
+    memset(out, 0, sizeof(*out));
+    put_bits(out, &pos, s->num_entities, 8);
+    for (i = 0; i < s->num_entities; i++) {
+        k = order[i];
+        put_bits(out, &pos, s->cell[k], 8);
+        put_bits(out, &pos, entity_code(s->type[k]), 2);
+        put_bits(out, &pos, is_hole(s->prev_under[k]), 1);
+    }
+    for (i = 0; i < c->num_doors; i++) {
+        put_bits(out, &pos, c->level_map[c->door_cells[i]] == TILE_DOOR, 1);
+    }
+    for (i = 0; i < c->num_gates; i++) {
+        cell = c->gate_cells[i];
+        k = c->entity_at[cell];
+        tile = k != ENTITY_NONE ? s->under[k] : c->level_map[cell];
+        put_bits(out, &pos, is_open_gate(tile), 1);
+    }
+    put_bits(out, &pos, c->gateA_open, 1);
+    put_bits(out, &pos, c->gateB_open, 1);
+    put_bits(out, &pos, c->gates_dirty, 1);
+    put_bits(out, &pos, c->prev_holeA_occupied, 1);
+    put_bits(out, &pos, c->prev_holeB_occupied, 1);
+}
+
+// Rebuild a context from a packed state, entities in canonical order
+static void decode_state(const PackedState* in, EngineContext* c) {
+    GameState* s = &c->game_state;
+    byte i, n, cell;
+    char type;
+    size_t pos = 0;
+
+    *c = level_start;
+    memcpy(c->level_map, static_map, sizeof(c->level_map));
+
+    n = (byte)get_bits(in, &pos, 8);
+    pos += (size_t)n * 11;
+    for (i = 0; i < c->num_doors; i++) {
+        c->level_map[c->door_cells[i]] = get_bits(in, &pos, 1) ? TILE_DOOR : TILE_FLOOR;
+    }
+    for (i = 0; i < c->num_gates; i++) {
+        cell = c->gate_cells[i];
+        if (c->background_map[cell] == TILE_GATE_A || c->background_map[cell] == TILE_GATE_A_OPEN) {
+            c->level_map[cell] = get_bits(in, &pos, 1) ? TILE_GATE_A_OPEN : TILE_GATE_A;
+        } else {
+            c->level_map[cell] = get_bits(in, &pos, 1) ? TILE_GATE_B_OPEN : TILE_GATE_B;
+        }
+    }
+
+    // Entities stand on whatever the map now shows at their cell
+    s->num_entities = n;
+    s->num_players = 0;
+    s->num_objects = 0;
+    s->level_complete = 0;
+    pos = 8;
+    for (i = 0; i < n; i++) {
+        cell = (byte)get_bits(in, &pos, 8);
+        type = entity_types[get_bits(in, &pos, 2)];
+        pos++;  // prev_under bit, restored below
+        s->cell[i] = cell;
+        s->type[i] = type;
+        s->under[i] = c->level_map[cell];
+        c->level_map[cell] = type;
+        if (type == TILE_PLAYER) {
+            s->num_players++;
+        } else {
+            s->num_objects++;
+        }
+    }
+    engine_reset_duplication_tracking(c);
+
+    // Restore what reset_duplication_tracking recomputes
+    pos = 8;
+    for (i = 0; i < n; i++) {
+        pos += 10;
+        s->prev_under[i] = get_bits(in, &pos, 1) ? TILE_HOLE_A : TILE_FLOOR;
+    }
+    pos += c->num_doors + c->num_gates;
+    c->gateA_open = (byte)get_bits(in, &pos, 1);
+    c->gateB_open = (byte)get_bits(in, &pos, 1);
+    c->gates_dirty = (byte)get_bits(in, &pos, 1);
+    c->prev_holeA_occupied = (byte)get_bits(in, &pos, 1);
+    c->prev_holeB_occupied = (byte)get_bits(in, &pos, 1);
+}
+
+// --check: a packed state must unpack to the same map, with every entity
+// in its canonical slot on the same tile and the plate counters unchanged
+static void check_state(const EngineContext* c, const PackedState* packed) {
+    EngineContext decoded;
+    byte order[MAX_ENTITIES], slot[MAX_ENTITIES];
+    byte i, k;
+
+    canonical_order(&c->game_state, order);
+    for (i = 0; i < c->game_state.num_entities; i++) {
+        slot[order[i]] = i;
+    }
+    decode_state(packed, &decoded);
+    if (memcmp(c->level_map, decoded.level_map, sizeof(c->level_map)) != 0
+            || c->plateA_count != decoded.plateA_count || c->plateB_count != decoded.plateB_count) {
+        fprintf(stderr, "Packed state does not match its context\n");
+        exit(1);
+    }
+    for (i = 0; i < c->game_state.num_entities; i++) {
+        k = decoded.entity_at[c->game_state.cell[i]];
+        if (k != slot[i] || decoded.game_state.type[k] != c->game_state.type[i]
+                || decoded.game_state.under[k] != c->game_state.under[i]
+                || is_hole(decoded.game_state.prev_under[k]) != is_hole(c->game_state.prev_under[i])) {
+            fprintf(stderr, "Packed entity does not match its context\n");
+            exit(1);
+        }
+    }
+}
+
+// Hash of a packed state (never SLOT_EMPTY or SLOT_BUSY)
+static uint64_t state_hash(const PackedState* p) {
+    uint64_t hash = hash_bytes(0xCBF29CE484222325ULL, p->bytes, sizeof(p->bytes));
+    return hash > SLOT_BUSY ? hash : hash + 2;
+}
+
+// Insert a state without locking; returns 0 if it was already there.
+// A slot is claimed by swapping SLOT_EMPTY for SLOT_BUSY, and its hash is
+// only published once the state is copied in, so a thread that meets a
+// busy slot waits for it before comparing.
+static int visited_insert(const PackedState* state) {
+    uint64_t hash = state_hash(state);
+    Shard* shard = &shards[hash >> (64 - SHARD_BITS)];
+    size_t mask = shard->capacity - 1;
+    size_t i = (size_t)hash & mask;
+    size_t probes;
+    uint64_t seen;
+
+    for (probes = 0; probes < shard->capacity; probes++) {
+        Slot* slot = &shard->slots[i];
+
+        seen = SLOT_EMPTY;
+        if (atomic_compare_exchange_strong(&slot->hash, &seen, SLOT_BUSY)) {
+            slot->state = *state;
+            atomic_store_explicit(&slot->hash, hash, memory_order_release);
+            atomic_fetch_add(&shard->count, 1);
+            return 1;
+        }
+        while (seen == SLOT_BUSY) {
+            seen = atomic_load_explicit(&slot->hash, memory_order_acquire);
+        }
+        if (seen == hash && memcmp(&slot->state, state, sizeof(*state)) == 0) {
+            return 0;
+        }
+        i = (i + 1) & mask;
+    }
+    fprintf(stderr, "Visited shard full\n");
+    exit(1);
+}
+
+static size_t visited_total(void) {
+    size_t i, total = 0;
+
+    for (i = 0; i < NUM_SHARDS; i++) {
+        total += atomic_load(&shards[i].count);
+    }
+    return total;
+}
+
+// Rehash one shard into a table of the given capacity (single-threaded)
+static void shard_resize(Shard* shard, size_t capacity) {
+    Slot* old = shard->slots;
+    size_t old_capacity = shard->capacity;
+    size_t i, j, mask = capacity - 1;
+    uint64_t hash;
+
+    shard->slots = checked_realloc(NULL, capacity * sizeof(Slot));
+    for (i = 0; i < capacity; i++) {
+        atomic_init(&shard->slots[i].hash, SLOT_EMPTY);
+    }
+    shard->capacity = capacity;
+    for (i = 0; i < old_capacity; i++) {
+        hash = atomic_load_explicit(&old[i].hash, memory_order_relaxed);
+        if (hash != SLOT_EMPTY) {
+            for (j = (size_t)hash & mask;
+                    atomic_load_explicit(&shard->slots[j].hash, memory_order_relaxed) != SLOT_EMPTY;
+                    j = (j + 1) & mask) {
+            }
+            atomic_store_explicit(&shard->slots[j].hash, hash, memory_order_relaxed);
+            shard->slots[j].state = old[i].state;
+        }
+    }
+    free(old);
+}
+
+static void visited_clear(void) {
+    size_t i, j;
+
+    // Shards are allocated by reserve_states, sized for the search
+    for (i = 0; i < NUM_SHARDS; i++) {
+        for (j = 0; j < shards[i].capacity; j++) {
+            atomic_init(&shards[i].slots[j].hash, SLOT_EMPTY);
+        }
+        atomic_init(&shards[i].count, 0);
+    }
+}
+
+// Make room for up to 'adding' more states before a layer starts:
+// every shard stays under half full for twice its fair share
+static void reserve_states(size_t adding) {
+    size_t per_shard = 2 * (adding / NUM_SHARDS) + 8;
+    size_t i, needed, capacity;
+
+    for (i = 0; i < NUM_SHARDS; i++) {
+        needed = 2 * (atomic_load(&shards[i].count) + per_shard);
+        for (capacity = shards[i].capacity ? shards[i].capacity : 16; capacity < needed; capacity *= 2) {
+        }
+        if (capacity != shards[i].capacity) {
+            shard_resize(&shards[i], capacity);
+        }
+    }
+
+    needed = atomic_load(&num_nodes) + adding;
+    if (needed > nodes_capacity) {
+        nodes_capacity = needed * 2;
+        nodes = checked_realloc(nodes, nodes_capacity * sizeof(Node));
+    }
+}
+
+// Bytes held by the search (what max_bytes limits)
+static size_t memory_in_use(void) {
+    size_t bytes = nodes_capacity * sizeof(Node) + current.capacity * sizeof(FrontierEntry);
+    int i;
+
+    for (i = 0; i < NUM_SHARDS; i++) {
+        bytes += shards[i].capacity * sizeof(Slot);
+    }
+    for (i = 0; i < num_threads; i++) {
+        bytes += workers[i].next.capacity * sizeof(FrontierEntry);
+    }
+    return bytes;
+}
+
+// Give the memory of the last search back, so each level starts small
+static void release_search(void) {
+    int i;
+
+    for (i = 0; i < NUM_SHARDS; i++) {
+        free(shards[i].slots);
+        shards[i].slots = NULL;
+        shards[i].capacity = 0;
+    }
+    for (i = 0; i < MAX_THREADS; i++) {
+        free(workers[i].next.items);
+        workers[i].next.items = NULL;
+        workers[i].next.capacity = 0;
+    }
+    free(current.items);
+    current.items = NULL;
+    current.capacity = 0;
+    free(nodes);
+    nodes = NULL;
+    nodes_capacity = 0;
+}
+
+static void init_workers(void) {
+    static int ready;
+    int t;
+
+    if (!ready) {
+        for (t = 0; t < MAX_THREADS; t++) {
+            workers[t].id = t;
+            pthread_mutex_init(&workers[t].deque.lock, NULL);
+        }
+        ready = 1;
+    }
+}
+
+static uint32_t add_node(uint32_t parent, char move) {
+    size_t n = atomic_fetch_add(&num_nodes, 1);
+
+    nodes[n].parent = parent;
+    nodes[n].move = move;
+    return (uint32_t)n;
+}
+
+static FrontierEntry* frontier_push(Frontier* f) {
+    if (f->count == f->capacity) {
+        f->capacity = f->capacity ? f->capacity * 2 : 1024;
+        f->items = checked_realloc(f->items, f->capacity * sizeof(FrontierEntry));
+    }
+    return &f->items[f->count++];
+}
+
+// Take a chunk from the bottom of our own deque
+static int deque_pop(Deque* d, size_t* chunk) {
+    int found = 0;
+
+    pthread_mutex_lock(&d->lock);
+    if (d->bottom > d->top) {
+        *chunk = d->chunks[--d->bottom];
+        found = 1;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return found;
+}
+
+// Take a chunk from the top of another thread's deque
+static int deque_steal(Deque* d, size_t* chunk) {
+    int found = 0;
+
+    pthread_mutex_lock(&d->lock);
+    if (d->bottom > d->top) {
+        *chunk = d->chunks[d->top++];
+        found = 1;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return found;
+}
+
+// Try all four moves from every state in a chunk of the frontier
+static void expand_chunk(Worker* w, size_t chunk) {
+    size_t first = chunk * chunk_size;
+    size_t last = first + chunk_size < current.count ? first + chunk_size : current.count;
+    const FrontierEntry* parent;
+    FrontierEntry* entry;
+    EngineContext unpacked, child;
+    PackedState packed;
+    GameState* state;
+    uint32_t node, expected;
+    size_t i;
+    int d;
+
+    for (i = first; i < last; i++) {
+        if (atomic_load_explicit(&goal_node, memory_order_relaxed) != NO_PARENT) {
+            return;
+        }
+        parent = &current.items[i];
+        decode_state(&parent->state, &unpacked);
+        w->level.expanded++;
+
+        for (d = 0; d < 4; d++) {
+            child = unpacked;
+            if (!engine_try_move_player(&child, move_dx[d], move_dy[d])) {
+                continue;
+            }
+
+            // The packed state has no room for won or lost, so check first
+            state = engine_get_game_state(&child);
+            if (state->level_complete == 1) {
+                node = add_node(parent->node, move_letters[d]);
+                expected = NO_PARENT;
+                atomic_compare_exchange_strong(&goal_node, &expected, node);
+                return;
+            }
+            if (state->level_complete == 2 || state->num_players == 0) {
+                continue;  // Lost
+            }
+
+            encode_state(&child, &packed);
+            if (check_encoding) {
+                check_state(&child, &packed);
+            }
+            if (!visited_insert(&packed)) {
+                w->level.duplicates++;
+                continue;
+            }
+
+            entry = frontier_push(&w->next);
+            entry->state = packed;
+            entry->node = add_node(parent->node, move_letters[d]);
+            w->level.generated++;
+        }
+    }
+}
+
+static void* worker_main(void* arg) {
+    Worker* w = (Worker*)arg;
+    double start = seconds_now();
+    size_t chunk;
+    int victim, tries;
+
+    while (1) {
+        if (!deque_pop(&w->deque, &chunk)) {
+            // Out of work: steal from the other threads in turn
+            for (tries = 1; tries < num_threads; tries++) {
+                victim = (w->id + tries) % num_threads;
+                if (deque_steal(&workers[victim].deque, &chunk)) {
+                    w->level.steals++;
+                    break;
+                }
+            }
+            if (tries >= num_threads) {
+                break;  // Nothing left anywhere in this layer
+            }
+        }
+        expand_chunk(w, chunk);
+    }
+
+    w->level.busy += seconds_now() - start;
+    return NULL;
+}
+
+// Expand the current layer on all threads; the children end up in each
+// worker's 'next' buffer
+static void expand_layer(void) {
+    pthread_t threads[MAX_THREADS];
+    size_t c, per_thread;
+    int t;
+
+    chunk_size = current.count / ((size_t)num_threads * 8);
+    if (chunk_size < 1) {
+        chunk_size = 1;
+    } else if (chunk_size > MAX_CHUNK) {
+        chunk_size = MAX_CHUNK;
+    }
+    num_chunks = (current.count + chunk_size - 1) / chunk_size;
+
+    // Deal contiguous runs of chunks to the threads
+    per_thread = (num_chunks + num_threads - 1) / num_threads;
+    for (t = 0; t < num_threads; t++) {
+        Deque* d = &workers[t].deque;
+
+        d->chunks = checked_realloc(d->chunks, (per_thread + 1) * sizeof(size_t));
+        d->top = 0;
+        d->bottom = 0;
+        for (c = t * per_thread; c < num_chunks && c < (size_t)(t + 1) * per_thread; c++) {
+            d->chunks[d->bottom++] = c;
+        }
+        workers[t].next.count = 0;
+    }
+
+    if (num_threads == 1) {
+        worker_main(&workers[0]);
+        return;
+    }
+    for (t = 0; t < num_threads; t++) {
+        if (pthread_create(&threads[t], NULL, worker_main, &workers[t]) != 0) {
+            fprintf(stderr, "Cannot start thread %d\n", t);
+            exit(1);
+        }
+    }
+    for (t = 0; t < num_threads; t++) {
+        pthread_join(threads[t], NULL);
+    }
+}
+
+// Write the moves leading to a node into out (NUL terminated)
+static size_t build_solution(uint32_t node, char* out, size_t size) {
+    size_t length = 0, i;
+    uint32_t n;
+
+    for (n = node; nodes[n].parent != NO_PARENT; n = nodes[n].parent) {
+        length++;
+    }
+    if (length >= size) {
+        length = size - 1;
+    }
+    out[length] = '\0';
+    i = length;
+    for (n = node; nodes[n].parent != NO_PARENT && i > 0; n = nodes[n].parent) {
+        out[--i] = nodes[n].move;
+    }
+    return length;
+}
+
+typedef enum { SOLVED, UNSOLVABLE, LIMIT } SolveResult;
+
+// Breadth-first search; on SOLVED the goal node is stored in *goal.
+// *peak is the largest layer, *peak_bytes the most memory in use.
+static SolveResult solve_level(const char* rows[], byte num_rows, uint32_t* goal,
+                               size_t* explored, size_t* peak, size_t* peak_bytes) {
+    double start = seconds_now();
+    FrontierEntry* entry;
+    size_t total;
+    byte i;
+    int t;
+
+    init_workers();
+    atomic_store(&num_nodes, 0);
+    atomic_store(&goal_node, NO_PARENT);
+    visited_clear();
+    reserve_states(1);
+    for (t = 0; t < num_threads; t++) {
+        memset(&workers[t].level, 0, sizeof(workers[t].level));
+    }
+
+    memset(&level_start, 0, sizeof(level_start));
+    engine_set_render_enabled(&level_start, 0);
+    engine_load_level(&level_start, rows, num_rows);
+    memcpy(static_map, level_start.level_map, sizeof(static_map));
+    for (i = 0; i < level_start.game_state.num_entities; i++) {
+        static_map[level_start.game_state.cell[i]] = level_start.game_state.under[i];
+    }
+
+    current.count = 0;
+    entry = frontier_push(&current);
+    encode_state(&level_start, &entry->state);
+    entry->node = add_node(NO_PARENT, 0);
+    visited_insert(&entry->state);
+    *peak = 1;
+    *peak_bytes = 0;
+
+    while (current.count > 0) {
+        if (visited_total() > max_states) {
+            break;
+        }
+        reserve_states(current.count * 4);
+        if (memory_in_use() > *peak_bytes) {
+            *peak_bytes = memory_in_use();
+        }
+        if ((max_bytes && *peak_bytes > max_bytes)
+                || (max_seconds && seconds_now() - start > max_seconds)) {
+            break;
+        }
+        expand_layer();
+        if (atomic_load(&goal_node) != NO_PARENT) {
+            break;
+        }
+
+        // The per-thread children become the next layer
+        total = 0;
+        for (t = 0; t < num_threads; t++) {
+            total += workers[t].next.count;
+        }
+        if (total > current.capacity) {
+            current.capacity = total;
+            current.items = checked_realloc(current.items, total * sizeof(FrontierEntry));
+        }
+        current.count = 0;
+        for (t = 0; t < num_threads; t++) {
+            memcpy(&current.items[current.count], workers[t].next.items,
+                   workers[t].next.count * sizeof(FrontierEntry));
+            current.count += workers[t].next.count;
+        }
+        if (current.count > *peak) {
+            *peak = current.count;
+        }
+    }
+
+    *explored = 0;
+    for (t = 0; t < num_threads; t++) {
+        ThreadStats* s = &workers[t].level;
+        ThreadStats* sum = &workers[t].total;
+
+        *explored += s->expanded;
+        sum->expanded += s->expanded;
+        sum->generated += s->generated;
+        sum->duplicates += s->duplicates;
+        sum->steals += s->steals;
+        sum->busy += s->busy;
+    }
+
+    *goal = (uint32_t)atomic_load(&goal_node);
+    if (*goal != NO_PARENT) {
+        return SOLVED;
+    }
+    return current.count > 0 ? LIMIT : UNSOLVABLE;
+}
+
+// Play a solution on a freshly loaded level (normal entity order)
+static byte replay_solution(const char* rows[], byte num_rows, const char* moves) {
+    EngineContext game;
+    const char* m;
+    int d;
+
+    memset(&game, 0, sizeof(game));
+    engine_set_render_enabled(&game, 0);
+    engine_load_level(&game, rows, num_rows);
+    for (m = moves; *m != '\0'; m++) {
+        for (d = 0; move_letters[d] != *m; d++) {
+        }
+        engine_try_move_player(&game, move_dx[d], move_dy[d]);
+    }
+    return game.game_state.level_complete == 1;
+}
+
+void duplicator_solve(const char* rows[], unsigned char num_rows,
+                      const SolverBudget* budget, SolverReport* report) {
+    double start = seconds_now();
+    size_t peak, length;
+    uint32_t goal, n;
+    SolveResult result;
+    byte y, player = 0;
+
+    memset(report, 0, sizeof(*report));
+
+    // Only what load_level can hold, with someone to move
+    if (num_rows == 0 || num_rows > MAX_LEVEL_HEIGHT) {
+        report->status = SOLVER_INVALID;
+        return;
+    }
+    for (y = 0; y < num_rows; y++) {
+        if (strlen(rows[y]) > MAX_LEVEL_WIDTH) {
+            report->status = SOLVER_INVALID;
+            return;
+        }
+        if (strchr(rows[y], TILE_PLAYER) != NULL || strchr(rows[y], 'z') != NULL) {
+            player = 1;
+        }
+    }
+    if (!player) {
+        report->status = SOLVER_INVALID;
+        return;
+    }
+
+    max_states = budget->max_states ? budget->max_states : SIZE_MAX;
+    max_seconds = budget->max_seconds;
+    max_bytes = budget->max_bytes;
+    num_threads = budget->threads < 1 ? 1 : budget->threads > MAX_THREADS ? MAX_THREADS : budget->threads;
+
+    result = solve_level(rows, num_rows, &goal, &report->nodes, &peak, &report->peak_bytes);
+    if (result == SOLVED) {
+        length = 0;
+        for (n = goal; nodes[n].parent != NO_PARENT; n = nodes[n].parent) {
+            length++;
+        }
+        report->solution = checked_realloc(NULL, length + 1);
+        build_solution(goal, report->solution, length + 1);
+        report->length = report->moves = (unsigned)length;
+        report->status = replay_solution(rows, num_rows, report->solution)
+            ? SOLVER_SOLVED : SOLVER_REPLAY_FAILED;
+    } else {
+        report->status = result == UNSOLVABLE ? SOLVER_UNSOLVABLE : SOLVER_BUDGET;
+    }
+    release_search();
+    report->seconds = seconds_now() - start;
+}
+
+#ifndef SOLVER_LIBRARY
+static void print_usage(const char* name) {
+    printf("Usage: %s [--level N] [--max-states N] [--threads N] [--check]\n", name);
+    printf("  --level N       Only solve level N (1-%d, default all)\n", NUM_LEVELS);
+    printf("  --max-states N  Give up on a level after N states (default %lu)\n",
+           (unsigned long)max_states);
+    printf("  --threads N     Worker threads (1-%d, default 1)\n", MAX_THREADS);
+    printf("  --check         Verify that every packed state unpacks to its context\n");
+}
+
+int main(int argc, char* argv[]) {
+    int first_level = 0, last_level = NUM_LEVELS - 1;
+    int i, t, level;
+    char solution[1024];
+    uint32_t goal;
+    size_t explored, peak, peak_bytes, length;
+    double start, elapsed, run_start;
+    SolveResult result;
+
+    for (i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--level") == 0) {
+            first_level = last_level = atoi(argv[++i]) - 1;
+        } else if (i + 1 < argc && strcmp(argv[i], "--max-states") == 0) {
+            max_states = strtoul(argv[++i], NULL, 10);
+        } else if (i + 1 < argc && strcmp(argv[i], "--threads") == 0) {
+            num_threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--check") == 0) {
+            check_encoding = 1;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (first_level < 0 || first_level >= NUM_LEVELS || max_states == 0
+            || num_threads < 1 || num_threads > MAX_THREADS) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    run_start = seconds_now();
+    for (level = first_level; level <= last_level; level++) {
+        start = seconds_now();
+        result = solve_level(levels[level], MAX_LEVEL_HEIGHT, &goal, &explored, &peak, &peak_bytes);
+        elapsed = seconds_now() - start;
+        if (elapsed <= 0) {
+            elapsed = 1e-9;
+        }
+
+        printf("Level %2d: ", level + 1);
+        if (result == SOLVED) {
+            length = build_solution(goal, solution, sizeof(solution));
+            printf("%3lu moves  %s%s\n", (unsigned long)length, solution,
+                   replay_solution(levels[level], MAX_LEVEL_HEIGHT, solution) ? "" : "  (fails on replay)");
+        } else if (result == UNSOLVABLE) {
+            printf("unsolvable\n");
+        } else {
+            printf("gave up after %lu states\n", (unsigned long)max_states);
+        }
+        printf("          %lu states explored, %lu visited, %.2fs (%.0f states/s)\n",
+               (unsigned long)explored, (unsigned long)visited_total(), elapsed, explored / elapsed);
+        printf("          largest layer %lu states, %lu KB packed, %lu KB searching\n",
+               (unsigned long)peak, (unsigned long)(peak * sizeof(FrontierEntry) / 1024),
+               (unsigned long)(peak_bytes / 1024));
+        release_search();
+    }
+    elapsed = seconds_now() - run_start;
+
+    printf("\nthread  expanded  generated  duplicates  steals   busy  states/s\n");
+    for (t = 0; t < num_threads; t++) {
+        ThreadStats* s = &workers[t].total;
+
+        printf("%6d %9lu %10lu %11lu %7lu %5.2fs %9.0f\n", t, (unsigned long)s->expanded,
+               (unsigned long)s->generated, (unsigned long)s->duplicates,
+               (unsigned long)s->steals, s->busy, s->busy > 0 ? s->expanded / s->busy : 0.0);
+    }
+    printf("Total time %.2fs\n", elapsed);
+
+    for (t = 0; t < num_threads; t++) {
+        free(workers[t].deque.chunks);
+    }
+    return 0;
+}
+#endif
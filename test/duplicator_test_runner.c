@@ -10,7 +10,11 @@
 
 #include "duplicator_game.h"
 #include "test_conio.h"
+#include "replay_format.h"
+#include "duplicator_levels_16x16.h"
+#include "duplicator_levels_16x16_packed.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 
@@ -78,16 +82,10 @@ void print_game_state(void) {
     
     printf("\n=== GAME STATE ===\n");
     printf("Level: %dx%d\n", state->level_width, state->level_height);
-    printf("Players: %d\n", state->num_players);
-    for (i = 0; i < state->num_players; i++) {
-        printf("  Player %d: (%d, %d) under='%c'\n", 
-               i, state->players[i].x, state->players[i].y, state->players[i].under);
-    }
-    printf("Objects: %d\n", state->num_objects);
-    for (i = 0; i < state->num_objects; i++) {
-        printf("  Object %d: type='%c' (%d, %d) under='%c'\n", 
-               i, state->objects[i].type, state->objects[i].x, state->objects[i].y, 
-               state->objects[i].under);
+    printf("Players: %d, Objects: %d\n", state->num_players, state->num_objects);
+    for (i = 0; i < state->num_entities; i++) {
+        printf("  Entity %d: type='%c' (%d, %d) under='%c'\n", 
+               i, state->type[i], cell_x(state->cell[i]), cell_y(state->cell[i]), state->under[i]);
     }
     printf("Level complete: %s\n", state->level_complete ? "YES" : "NO");
     printf("==================\n");
@@ -100,6 +98,65 @@ void print_level(void) {
     printf("==================\n");
 }
 
+// Helper function to append an entity to the table
+// (call reset_duplication_tracking() once setup is complete)
+void add_test_entity(byte x, byte y, char type, char under) {
+    GameState* state = get_game_state();
+    byte n = state->num_entities++;
+
+    state->cell[n] = CELL(x, y);
+    state->type[n] = type;
+    state->under[n] = under;
+    if (type == TILE_PLAYER) {
+        state->num_players++;
+    } else {
+        state->num_objects++;
+    }
+    set_tile(x, y, type);
+}
+
+// Helper function to find the table slot of the n-th entity of a type
+byte entity_slot(char type, byte n) {
+    GameState* state = get_game_state();
+    byte i;
+
+    for (i = 0; i < state->num_entities; i++) {
+        if (state->type[i] == type && n-- == 0) {
+            return i;
+        }
+    }
+    assert(0 && "entity not found");
+    return ENTITY_NONE;
+}
+
+// Helper function to check that the occupancy index matches the entity table
+void verify_entity_index(void) {
+    GameState* state = get_game_state();
+    byte i, x, y;
+    byte occupied = 0;
+    byte players = 0;
+
+    for (i = 0; i < state->num_entities; i++) {
+        assert(state->type[i] != ENTITY_REMOVED);
+        assert(get_entity_at(cell_x(state->cell[i]), cell_y(state->cell[i])) == i);
+        if (state->type[i] == TILE_PLAYER) {
+            players++;
+        }
+    }
+    assert(players == state->num_players);
+    assert(state->num_entities == state->num_players + state->num_objects);
+
+    // No stale entries may be left behind on cells nobody stands on
+    for (y = 0; y < MAX_LEVEL_HEIGHT; y++) {
+        for (x = 0; x < MAX_LEVEL_WIDTH; x++) {
+            if (get_entity_at(x, y) != ENTITY_NONE) {
+                occupied++;
+            }
+        }
+    }
+    assert(occupied == state->num_entities);
+}
+
 // Helper function to execute a sequence of moves
 // Moves: 'u'=up, 'd'=down, 'l'=left, 'r'=right
 void execute_moves(const char* moves) {
@@ -127,9 +184,12 @@ void execute_moves(const char* moves) {
                 printf("Unknown move: '%c'\n", move);
                 continue;
         }
+        wait_vblank();
+        flush_dirty_cells();
         
         print_level();
         print_game_state();
+        verify_entity_index();
     }
 }
 
@@ -148,29 +208,29 @@ void test_simple_movement(void) {
     
     GameState* state = get_game_state();
     assert(state->num_players == 1);
-    byte initial_x = state->players[0].x;
-    byte initial_y = state->players[0].y;
+    byte initial_x = cell_x(state->cell[entity_slot(TILE_PLAYER, 0)]);
+    byte initial_y = cell_y(state->cell[entity_slot(TILE_PLAYER, 0)]);
     printf("Initial player position: (%d, %d)\n", initial_x, initial_y);
     
     // Move right
     execute_moves("r");
-    assert(state->players[0].x == initial_x + 1);
-    assert(state->players[0].y == initial_y);
+    assert(cell_x(state->cell[entity_slot(TILE_PLAYER, 0)]) == initial_x + 1);
+    assert(cell_y(state->cell[entity_slot(TILE_PLAYER, 0)]) == initial_y);
 
     // Move up
     execute_moves("u");
-    assert(state->players[0].x == initial_x + 1);
-    assert(state->players[0].y == initial_y - 1);
+    assert(cell_x(state->cell[entity_slot(TILE_PLAYER, 0)]) == initial_x + 1);
+    assert(cell_y(state->cell[entity_slot(TILE_PLAYER, 0)]) == initial_y - 1);
 
     // Move left
     execute_moves("l");
-    assert(state->players[0].x == initial_x);
-    assert(state->players[0].y == initial_y - 1);
+    assert(cell_x(state->cell[entity_slot(TILE_PLAYER, 0)]) == initial_x);
+    assert(cell_y(state->cell[entity_slot(TILE_PLAYER, 0)]) == initial_y - 1);
 
     // Move down
     execute_moves("d");
-    assert(state->players[0].x == initial_x);
-    assert(state->players[0].y == initial_y);
+    assert(cell_x(state->cell[entity_slot(TILE_PLAYER, 0)]) == initial_x);
+    assert(cell_y(state->cell[entity_slot(TILE_PLAYER, 0)]) == initial_y);
     
     printf("\n✓ TEST PASSED: Simple Movement\n");
 }
@@ -235,8 +295,8 @@ void test_hole_duplication(void) {
     byte in_hole_b = 0;
     byte i;
     for (i = 0; i < state->num_players; i++) {
-        if (state->players[i].under == TILE_HOLE_A) in_hole_a++;
-        if (state->players[i].under == TILE_HOLE_B) in_hole_b++;
+        if (state->under[entity_slot(TILE_PLAYER, i)] == TILE_HOLE_A) in_hole_a++;
+        if (state->under[entity_slot(TILE_PLAYER, i)] == TILE_HOLE_B) in_hole_b++;
     }
     assert(in_hole_a == 1);
     assert(in_hole_b == 1);
@@ -266,7 +326,7 @@ void test_gate_plate(void) {
 
     printf("\nPlayer should be on plate:");
     print_game_state();
-    assert(state->players[0].under == TILE_PLATE_A);
+    assert(state->under[entity_slot(TILE_PLAYER, 0)] == TILE_PLATE_A);
     printf("✓ Player is on pressure plate A\n");
 
     // Gate should be open now - check the level map
@@ -293,6 +353,41 @@ void test_gate_plate(void) {
     printf("\n✓ TEST PASSED: Gate and Pressure Plate\n");
 }
 
+// Test case: crate on plate, and a gate uncovered after its plate was released
+void test_gate_crate_plate(void) {
+    const char* level[] = {
+        "##########",
+        "#p*b.g...#",
+        "##########"
+    };
+
+    printf("\n\n========================================\n");
+    printf("TEST: Gate With Crate On Plate\n");
+    printf("========================================\n");
+
+    load_level(level, 3);
+    draw_level();
+
+    // Crate onto the plate opens the gate
+    execute_moves("r");
+    assert(get_tile(5, 1) == TILE_GATE_A_OPEN);
+
+    // Player takes over the plate, gate stays open
+    execute_moves("r");
+    assert(get_tile(5, 1) == TILE_GATE_A_OPEN);
+
+    // Crate moves onto the open gate as the player leaves the plate
+    execute_moves("r");
+    assert(get_tile(5, 1) == TILE_CRATE);
+
+    // Player steps onto the gate cell, then off it: the gate must close
+    execute_moves("r r");
+    assert(get_tile(5, 1) == TILE_GATE_A);
+    printf("✓ Gate closed once uncovered\n");
+
+    printf("\n✓ TEST PASSED: Gate With Crate On Plate\n");
+}
+
 // Test case: 3 players in horizontal line (should expose bug)
 void test_three_players_horizontal(void) {
     printf("\n\n========================================\n");
@@ -307,22 +402,12 @@ void test_three_players_horizontal(void) {
     // Manually add 2 more players to create a horizontal line of 3
     // Player 0 is at (8, 3) from level load
     // Add player 1 at (7, 3) - left of player 0
-    state->players[1].x = 7;
-    state->players[1].y = 3;
-    state->players[1].under = TILE_FLOOR;
-    state->num_players = 2;
+    add_test_entity(7, 3, TILE_PLAYER, TILE_FLOOR);
 
     // Add player 2 at (9, 3) - right of player 0
-    state->players[2].x = 9;
-    state->players[2].y = 3;
-    state->players[2].under = TILE_FLOOR;
-    state->num_players = 3;
-
-    // Draw all players on the map
-    set_tile(7, 3, TILE_PLAYER);
-    set_tile(8, 3, TILE_PLAYER);
-    set_tile(9, 3, TILE_PLAYER);
+    add_test_entity(9, 3, TILE_PLAYER, TILE_FLOOR);
 
+    reset_duplication_tracking();
     draw_level();
 
     printf("\nInitial state (3 players in horizontal line):");
@@ -334,10 +419,10 @@ void test_three_players_horizontal(void) {
     printf("✓ Have 3 players as expected\n");
 
     // Record initial positions
-    byte initial_x0 = state->players[0].x;
-    byte initial_x1 = state->players[1].x;
-    byte initial_x2 = state->players[2].x;
-    byte initial_y = state->players[0].y;
+    byte initial_x0 = cell_x(state->cell[entity_slot(TILE_PLAYER, 0)]);
+    byte initial_x1 = cell_x(state->cell[entity_slot(TILE_PLAYER, 1)]);
+    byte initial_x2 = cell_x(state->cell[entity_slot(TILE_PLAYER, 2)]);
+    byte initial_y = cell_y(state->cell[entity_slot(TILE_PLAYER, 0)]);
 
     printf("\nInitial positions:\n");
     printf("  Player 0: (%d, %d)\n", initial_x0, initial_y);
@@ -353,14 +438,14 @@ void test_three_players_horizontal(void) {
     print_level();
 
     // Check if all 3 players moved
-    byte moved_0 = (state->players[0].x == initial_x0 + 1);
-    byte moved_1 = (state->players[1].x == initial_x1 + 1);
-    byte moved_2 = (state->players[2].x == initial_x2 + 1);
+    byte moved_0 = (cell_x(state->cell[entity_slot(TILE_PLAYER, 0)]) == initial_x0 + 1);
+    byte moved_1 = (cell_x(state->cell[entity_slot(TILE_PLAYER, 1)]) == initial_x1 + 1);
+    byte moved_2 = (cell_x(state->cell[entity_slot(TILE_PLAYER, 2)]) == initial_x2 + 1);
 
     printf("\nMovement check:\n");
-    printf("  Player 0: %s (from %d to %d)\n", moved_0 ? "MOVED" : "STUCK", initial_x0, state->players[0].x);
-    printf("  Player 1: %s (from %d to %d)\n", moved_1 ? "MOVED" : "STUCK", initial_x1, state->players[1].x);
-    printf("  Player 2: %s (from %d to %d)\n", moved_2 ? "MOVED" : "STUCK", initial_x2, state->players[2].x);
+    printf("  Player 0: %s (from %d to %d)\n", moved_0 ? "MOVED" : "STUCK", initial_x0, cell_x(state->cell[entity_slot(TILE_PLAYER, 0)]));
+    printf("  Player 1: %s (from %d to %d)\n", moved_1 ? "MOVED" : "STUCK", initial_x1, cell_x(state->cell[entity_slot(TILE_PLAYER, 1)]));
+    printf("  Player 2: %s (from %d to %d)\n", moved_2 ? "MOVED" : "STUCK", initial_x2, cell_x(state->cell[entity_slot(TILE_PLAYER, 2)]));
 
     // This assertion should FAIL if there's a bug
     if (!moved_0 || !moved_1 || !moved_2) {
@@ -371,9 +456,9 @@ void test_three_players_horizontal(void) {
     }
 
     // Update positions for next test
-    initial_x0 = state->players[0].x;
-    initial_x1 = state->players[1].x;
-    initial_x2 = state->players[2].x;
+    initial_x0 = cell_x(state->cell[entity_slot(TILE_PLAYER, 0)]);
+    initial_x1 = cell_x(state->cell[entity_slot(TILE_PLAYER, 1)]);
+    initial_x2 = cell_x(state->cell[entity_slot(TILE_PLAYER, 2)]);
 
     // Move left - all 3 players should move
     printf("\nMoving LEFT (all 3 players should move together)...");
@@ -384,14 +469,14 @@ void test_three_players_horizontal(void) {
     print_level();
 
     // Check if all 3 players moved
-    moved_0 = (state->players[0].x == initial_x0 - 1);
-    moved_1 = (state->players[1].x == initial_x1 - 1);
-    moved_2 = (state->players[2].x == initial_x2 - 1);
+    moved_0 = (cell_x(state->cell[entity_slot(TILE_PLAYER, 0)]) == initial_x0 - 1);
+    moved_1 = (cell_x(state->cell[entity_slot(TILE_PLAYER, 1)]) == initial_x1 - 1);
+    moved_2 = (cell_x(state->cell[entity_slot(TILE_PLAYER, 2)]) == initial_x2 - 1);
 
     printf("\nMovement check:\n");
-    printf("  Player 0: %s (from %d to %d)\n", moved_0 ? "MOVED" : "STUCK", initial_x0, state->players[0].x);
-    printf("  Player 1: %s (from %d to %d)\n", moved_1 ? "MOVED" : "STUCK", initial_x1, state->players[1].x);
-    printf("  Player 2: %s (from %d to %d)\n", moved_2 ? "MOVED" : "STUCK", initial_x2, state->players[2].x);
+    printf("  Player 0: %s (from %d to %d)\n", moved_0 ? "MOVED" : "STUCK", initial_x0, cell_x(state->cell[entity_slot(TILE_PLAYER, 0)]));
+    printf("  Player 1: %s (from %d to %d)\n", moved_1 ? "MOVED" : "STUCK", initial_x1, cell_x(state->cell[entity_slot(TILE_PLAYER, 1)]));
+    printf("  Player 2: %s (from %d to %d)\n", moved_2 ? "MOVED" : "STUCK", initial_x2, cell_x(state->cell[entity_slot(TILE_PLAYER, 2)]));
 
     // This assertion should FAIL if there's a bug
     if (!moved_0 || !moved_1 || !moved_2) {
@@ -418,38 +503,18 @@ void test_players_and_keys_line(void) {
     // Manually create the line: p k p k p
     // Player 0 at (8, 3) from level load
     // Key 0 at (9, 3)
-    state->objects[0].x = 9;
-    state->objects[0].y = 3;
-    state->objects[0].type = TILE_KEY;
-    state->objects[0].under = TILE_FLOOR;
-    state->num_objects = 1;
+    add_test_entity(9, 3, TILE_KEY, TILE_FLOOR);
 
     // Player 1 at (10, 3)
-    state->players[1].x = 10;
-    state->players[1].y = 3;
-    state->players[1].under = TILE_FLOOR;
-    state->num_players = 2;
+    add_test_entity(10, 3, TILE_PLAYER, TILE_FLOOR);
 
     // Key 1 at (11, 3)
-    state->objects[1].x = 11;
-    state->objects[1].y = 3;
-    state->objects[1].type = TILE_KEY;
-    state->objects[1].under = TILE_FLOOR;
-    state->num_objects = 2;
+    add_test_entity(11, 3, TILE_KEY, TILE_FLOOR);
 
     // Player 2 at (12, 3)
-    state->players[2].x = 12;
-    state->players[2].y = 3;
-    state->players[2].under = TILE_FLOOR;
-    state->num_players = 3;
-
-    // Draw all objects on the map
-    set_tile(8, 3, TILE_PLAYER);   // p
-    set_tile(9, 3, TILE_KEY);      // k
-    set_tile(10, 3, TILE_PLAYER);  // p
-    set_tile(11, 3, TILE_KEY);     // k
-    set_tile(12, 3, TILE_PLAYER);  // p
+    add_test_entity(12, 3, TILE_PLAYER, TILE_FLOOR);
 
+    reset_duplication_tracking();
     draw_level();
 
     printf("\nInitial state (p k p k p in horizontal line):");
@@ -462,11 +527,11 @@ void test_players_and_keys_line(void) {
     printf("✓ Have 3 players and 2 keys as expected\n");
 
     // Record initial positions
-    byte initial_p0_x = state->players[0].x;
-    byte initial_p1_x = state->players[1].x;
-    byte initial_p2_x = state->players[2].x;
-    byte initial_k0_x = state->objects[0].x;
-    byte initial_k1_x = state->objects[1].x;
+    byte initial_p0_x = cell_x(state->cell[entity_slot(TILE_PLAYER, 0)]);
+    byte initial_p1_x = cell_x(state->cell[entity_slot(TILE_PLAYER, 1)]);
+    byte initial_p2_x = cell_x(state->cell[entity_slot(TILE_PLAYER, 2)]);
+    byte initial_k0_x = cell_x(state->cell[entity_slot(TILE_KEY, 0)]);
+    byte initial_k1_x = cell_x(state->cell[entity_slot(TILE_KEY, 1)]);
 
     printf("\nInitial positions:\n");
     printf("  Player 0: (%d, 3)\n", initial_p0_x);
@@ -484,18 +549,18 @@ void test_players_and_keys_line(void) {
     print_level();
 
     // Check if all objects moved
-    byte p0_moved = (state->players[0].x == initial_p0_x + 1);
-    byte p1_moved = (state->players[1].x == initial_p1_x + 1);
-    byte p2_moved = (state->players[2].x == initial_p2_x + 1);
-    byte k0_moved = (state->objects[0].x == initial_k0_x + 1);
-    byte k1_moved = (state->objects[1].x == initial_k1_x + 1);
+    byte p0_moved = (cell_x(state->cell[entity_slot(TILE_PLAYER, 0)]) == initial_p0_x + 1);
+    byte p1_moved = (cell_x(state->cell[entity_slot(TILE_PLAYER, 1)]) == initial_p1_x + 1);
+    byte p2_moved = (cell_x(state->cell[entity_slot(TILE_PLAYER, 2)]) == initial_p2_x + 1);
+    byte k0_moved = (cell_x(state->cell[entity_slot(TILE_KEY, 0)]) == initial_k0_x + 1);
+    byte k1_moved = (cell_x(state->cell[entity_slot(TILE_KEY, 1)]) == initial_k1_x + 1);
 
     printf("\nMovement check:\n");
-    printf("  Player 0: %s (from %d to %d)\n", p0_moved ? "MOVED" : "STUCK", initial_p0_x, state->players[0].x);
-    printf("  Key 0:    %s (from %d to %d)\n", k0_moved ? "MOVED" : "STUCK", initial_k0_x, state->objects[0].x);
-    printf("  Player 1: %s (from %d to %d)\n", p1_moved ? "MOVED" : "STUCK", initial_p1_x, state->players[1].x);
-    printf("  Key 1:    %s (from %d to %d)\n", k1_moved ? "MOVED" : "STUCK", initial_k1_x, state->objects[1].x);
-    printf("  Player 2: %s (from %d to %d)\n", p2_moved ? "MOVED" : "STUCK", initial_p2_x, state->players[2].x);
+    printf("  Player 0: %s (from %d to %d)\n", p0_moved ? "MOVED" : "STUCK", initial_p0_x, cell_x(state->cell[entity_slot(TILE_PLAYER, 0)]));
+    printf("  Key 0:    %s (from %d to %d)\n", k0_moved ? "MOVED" : "STUCK", initial_k0_x, cell_x(state->cell[entity_slot(TILE_KEY, 0)]));
+    printf("  Player 1: %s (from %d to %d)\n", p1_moved ? "MOVED" : "STUCK", initial_p1_x, cell_x(state->cell[entity_slot(TILE_PLAYER, 1)]));
+    printf("  Key 1:    %s (from %d to %d)\n", k1_moved ? "MOVED" : "STUCK", initial_k1_x, cell_x(state->cell[entity_slot(TILE_KEY, 1)]));
+    printf("  Player 2: %s (from %d to %d)\n", p2_moved ? "MOVED" : "STUCK", initial_p2_x, cell_x(state->cell[entity_slot(TILE_PLAYER, 2)]));
 
     // This assertion should pass if the fix works
     if (!p0_moved || !p1_moved || !p2_moved || !k0_moved || !k1_moved) {
@@ -506,11 +571,11 @@ void test_players_and_keys_line(void) {
     }
 
     // Update positions for next test
-    initial_p0_x = state->players[0].x;
-    initial_p1_x = state->players[1].x;
-    initial_p2_x = state->players[2].x;
-    initial_k0_x = state->objects[0].x;
-    initial_k1_x = state->objects[1].x;
+    initial_p0_x = cell_x(state->cell[entity_slot(TILE_PLAYER, 0)]);
+    initial_p1_x = cell_x(state->cell[entity_slot(TILE_PLAYER, 1)]);
+    initial_p2_x = cell_x(state->cell[entity_slot(TILE_PLAYER, 2)]);
+    initial_k0_x = cell_x(state->cell[entity_slot(TILE_KEY, 0)]);
+    initial_k1_x = cell_x(state->cell[entity_slot(TILE_KEY, 1)]);
 
     // Move left - all 5 objects should move
     printf("\nMoving LEFT (all 5 objects should move together)...");
@@ -521,18 +586,18 @@ void test_players_and_keys_line(void) {
     print_level();
 
     // Check if all objects moved
-    p0_moved = (state->players[0].x == initial_p0_x - 1);
-    p1_moved = (state->players[1].x == initial_p1_x - 1);
-    p2_moved = (state->players[2].x == initial_p2_x - 1);
-    k0_moved = (state->objects[0].x == initial_k0_x - 1);
-    k1_moved = (state->objects[1].x == initial_k1_x - 1);
+    p0_moved = (cell_x(state->cell[entity_slot(TILE_PLAYER, 0)]) == initial_p0_x - 1);
+    p1_moved = (cell_x(state->cell[entity_slot(TILE_PLAYER, 1)]) == initial_p1_x - 1);
+    p2_moved = (cell_x(state->cell[entity_slot(TILE_PLAYER, 2)]) == initial_p2_x - 1);
+    k0_moved = (cell_x(state->cell[entity_slot(TILE_KEY, 0)]) == initial_k0_x - 1);
+    k1_moved = (cell_x(state->cell[entity_slot(TILE_KEY, 1)]) == initial_k1_x - 1);
 
     printf("\nMovement check:\n");
-    printf("  Player 0: %s (from %d to %d)\n", p0_moved ? "MOVED" : "STUCK", initial_p0_x, state->players[0].x);
-    printf("  Key 0:    %s (from %d to %d)\n", k0_moved ? "MOVED" : "STUCK", initial_k0_x, state->objects[0].x);
-    printf("  Player 1: %s (from %d to %d)\n", p1_moved ? "MOVED" : "STUCK", initial_p1_x, state->players[1].x);
-    printf("  Key 1:    %s (from %d to %d)\n", k1_moved ? "MOVED" : "STUCK", initial_k1_x, state->objects[1].x);
-    printf("  Player 2: %s (from %d to %d)\n", p2_moved ? "MOVED" : "STUCK", initial_p2_x, state->players[2].x);
+    printf("  Player 0: %s (from %d to %d)\n", p0_moved ? "MOVED" : "STUCK", initial_p0_x, cell_x(state->cell[entity_slot(TILE_PLAYER, 0)]));
+    printf("  Key 0:    %s (from %d to %d)\n", k0_moved ? "MOVED" : "STUCK", initial_k0_x, cell_x(state->cell[entity_slot(TILE_KEY, 0)]));
+    printf("  Player 1: %s (from %d to %d)\n", p1_moved ? "MOVED" : "STUCK", initial_p1_x, cell_x(state->cell[entity_slot(TILE_PLAYER, 1)]));
+    printf("  Key 1:    %s (from %d to %d)\n", k1_moved ? "MOVED" : "STUCK", initial_k1_x, cell_x(state->cell[entity_slot(TILE_KEY, 1)]));
+    printf("  Player 2: %s (from %d to %d)\n", p2_moved ? "MOVED" : "STUCK", initial_p2_x, cell_x(state->cell[entity_slot(TILE_PLAYER, 2)]));
 
     // This assertion should pass if the fix works
     if (!p0_moved || !p1_moved || !p2_moved || !k0_moved || !k1_moved) {
@@ -567,35 +632,21 @@ void test_key_pushed_off_hole(void) {
     state = get_game_state();
 
     // Manually place keys on the holes and player below hole B
-    state->objects[0].x = 2;
-    state->objects[0].y = 1;
-    state->objects[0].type = TILE_KEY;
-    state->objects[0].under = TILE_HOLE_A;
-    set_tile(2, 1, TILE_KEY);
-
-    state->objects[1].x = 6;
-    state->objects[1].y = 1;
-    state->objects[1].type = TILE_KEY;
-    state->objects[1].under = TILE_HOLE_B;
-    set_tile(6, 1, TILE_KEY);
-
-    state->num_objects = 2;
+    add_test_entity(2, 1, TILE_KEY, TILE_HOLE_A);
+    add_test_entity(6, 1, TILE_KEY, TILE_HOLE_B);
 
     // Place player directly below hole B
-    state->players[0].x = 6;
-    state->players[0].y = 2;
-    state->players[0].under = TILE_FLOOR;
-    set_tile(6, 2, TILE_PLAYER);
+    add_test_entity(6, 2, TILE_PLAYER, TILE_FLOOR);
 
     // Reset duplication tracking so keys already on holes don't trigger duplication
     reset_duplication_tracking();
 
     printf("Initial state:\n");
-    printf("  Player at (%d, %d)\n", state->players[0].x, state->players[0].y);
+    printf("  Player at (%d, %d)\n", cell_x(state->cell[entity_slot(TILE_PLAYER, 0)]), cell_y(state->cell[entity_slot(TILE_PLAYER, 0)]));
     printf("  Key 0 at (%d, %d) under='%c' (on hole A)\n",
-           state->objects[0].x, state->objects[0].y, state->objects[0].under);
+           cell_x(state->cell[entity_slot(TILE_KEY, 0)]), cell_y(state->cell[entity_slot(TILE_KEY, 0)]), state->under[entity_slot(TILE_KEY, 0)]);
     printf("  Key 1 at (%d, %d) under='%c' (on hole B)\n",
-           state->objects[1].x, state->objects[1].y, state->objects[1].under);
+           cell_x(state->cell[entity_slot(TILE_KEY, 1)]), cell_y(state->cell[entity_slot(TILE_KEY, 1)]), state->under[entity_slot(TILE_KEY, 1)]);
     printf("  Hole A at (2, 1), Hole B at (6, 1)\n");
     printf("  Number of keys: %d\n\n", state->num_objects);
 
@@ -603,14 +654,14 @@ void test_key_pushed_off_hole(void) {
     printf("Move 1: Player UP (pushes key 1 OFF hole B)\n");
     execute_moves("U");
     printf("  Player at (%d, %d) under='%c'\n",
-           state->players[0].x, state->players[0].y, state->players[0].under);
+           cell_x(state->cell[entity_slot(TILE_PLAYER, 0)]), cell_y(state->cell[entity_slot(TILE_PLAYER, 0)]), state->under[entity_slot(TILE_PLAYER, 0)]);
 
     // Print all keys
     printf("  Keys:\n");
-    for (i = 0; i < state->num_objects; i++) {
-        if (state->objects[i].type == TILE_KEY) {
+    for (i = 0; i < state->num_entities; i++) {
+        if (state->type[i] == TILE_KEY) {
             printf("    Key %d at (%d, %d) under='%c'\n",
-                   i, state->objects[i].x, state->objects[i].y, state->objects[i].under);
+                   i, cell_x(state->cell[i]), cell_y(state->cell[i]), state->under[i]);
         }
     }
     printf("  Number of keys: %d\n\n", state->num_objects);
@@ -621,14 +672,14 @@ void test_key_pushed_off_hole(void) {
     execute_moves("D");
     printf("  After move:\n");
     printf("    Player at (%d, %d) under='%c'\n",
-           state->players[0].x, state->players[0].y, state->players[0].under);
+           cell_x(state->cell[entity_slot(TILE_PLAYER, 0)]), cell_y(state->cell[entity_slot(TILE_PLAYER, 0)]), state->under[entity_slot(TILE_PLAYER, 0)]);
 
     // Print all keys
     printf("    Keys:\n");
-    for (i = 0; i < state->num_objects; i++) {
-        if (state->objects[i].type == TILE_KEY) {
+    for (i = 0; i < state->num_entities; i++) {
+        if (state->type[i] == TILE_KEY) {
             printf("      Key %d at (%d, %d) under='%c'\n",
-                   i, state->objects[i].x, state->objects[i].y, state->objects[i].under);
+                   i, cell_x(state->cell[i]), cell_y(state->cell[i]), state->under[i]);
         }
     }
     printf("    Number of keys: %d\n", state->num_objects);
@@ -652,6 +703,509 @@ void test_key_pushed_off_hole(void) {
     printf("✓ TEST PASSED: Key Pushed OFF Hole\n\n");
 }
 
+// Test case: occupancy index stays in sync through kills and key consumption
+void test_entity_index_tracking(void) {
+    GameState* state;
+
+    const char* kill_level[] = {
+        "##########",
+        "#?...#..!#",
+        "#p......e#",
+        "##########"
+    };
+
+    const char* door_level[] = {
+        "##########",
+        "#p*kd...:#",
+        "##########"
+    };
+
+    printf("\n\n========================================\n");
+    printf("TEST: Entity Index Tracking\n");
+    printf("========================================\n");
+
+    load_level(kill_level, 4);
+    draw_level();
+    verify_entity_index();
+    state = get_game_state();
+
+    // Entering hole A duplicates into hole B, right next to the enemy
+    execute_moves("u");
+    assert(state->num_players == 1);
+    assert(state->type[get_entity_at(8, 1)] == TILE_ENEMY);
+    assert(get_entity_at(8, 2) == ENTITY_NONE);
+    printf("✓ Duplicate was caught and the index followed the enemy\n");
+
+    load_level(door_level, 3);
+    draw_level();
+    verify_entity_index();
+
+    // Chain push: the key hits the door and is consumed, the crate moves on
+    execute_moves("r");
+    assert(state->num_objects == 1);
+    assert(state->type[get_entity_at(3, 1)] == TILE_CRATE);
+    assert(state->type[get_entity_at(2, 1)] == TILE_PLAYER);
+    printf("✓ Key consumed and crate re-indexed\n");
+
+    printf("\n✓ TEST PASSED: Entity Index Tracking\n");
+}
+
+// Test case: removals keep the table order enemies pick their target by
+void test_enemy_target_order(void) {
+    GameState* state;
+
+    const char* chase_level[] = {
+        "##########",
+        "#.......d#",
+        "#######.##",
+        "#........#",
+        "##########"
+    };
+
+    printf("\n\n========================================\n");
+    printf("TEST: Enemy Target Order\n");
+    printf("========================================\n");
+
+    load_level(chase_level, 5);
+    state = get_game_state();
+
+    // The key sits in front of the last player, so a swap-remove of its
+    // slot would move that player ahead of the first one
+    add_test_entity(7, 1, TILE_KEY, TILE_FLOOR);
+    add_test_entity(1, 3, TILE_PLAYER, TILE_FLOOR);
+    add_test_entity(7, 3, TILE_ENEMY, TILE_FLOOR);
+    add_test_entity(6, 1, TILE_PLAYER, TILE_FLOOR);
+    reset_duplication_tracking();
+    draw_level();
+    verify_entity_index();
+
+    // The key opens the door; afterwards the enemy sees both players
+    execute_moves("r");
+    assert(state->num_objects == 1);
+    assert(state->num_players == 1);
+    assert(state->type[get_entity_at(2, 3)] == TILE_ENEMY);
+    assert(state->type[get_entity_at(7, 1)] == TILE_PLAYER);
+    assert(state->level_complete == 0);
+    printf("✓ Enemy caught the first player in table order\n");
+
+    printf("\n✓ TEST PASSED: Enemy Target Order\n");
+}
+
+// Test case: screen changes are deferred to flush_dirty_cells, one draw per cell
+void test_dirty_cell_flush(void) {
+    byte x;
+
+    const char* push_level[] = {
+        "#######",
+        "#p*...#",
+        "#######"
+    };
+
+    printf("\n\n========================================\n");
+    printf("TEST: Dirty Cell Flush\n");
+    printf("========================================\n");
+
+    my_clrscr();
+    load_level(push_level, 3);
+    draw_level();
+
+    // The push changes 3 cells; the crate's old cell changes twice
+    try_move_player(1, 0);
+    assert(get_tile(2, 1) == TILE_PLAYER);
+    assert(get_screen_char(2, 1 + SCREEN_TOP_MARGIN) == TILE_CRATE);
+    printf("✓ Screen untouched until flush\n");
+
+    assert(flush_dirty_cells() == 3);
+    for (x = 0; x < 7; x++) {
+        assert(get_screen_char(x, 1 + SCREEN_TOP_MARGIN) == get_tile(x, 1));
+    }
+    assert(flush_dirty_cells() == 0);
+    printf("✓ Flush drew each changed cell once\n");
+
+    printf("\n✓ TEST PASSED: Dirty Cell Flush\n");
+}
+
+// Test case: Headless simulation leaves the screen alone
+void test_headless_mode(void) {
+    byte x;
+
+    const char* push_level[] = {
+        "#######",
+        "#p*...#",
+        "#######"
+    };
+
+    printf("\n\n========================================\n");
+    printf("TEST: Headless Mode\n");
+    printf("========================================\n");
+
+    my_clrscr();
+    load_level(push_level, 3);
+    draw_level();
+
+    set_render_enabled(0);
+    execute_moves("r r");
+    assert(get_tile(3, 1) == TILE_PLAYER);
+    assert(get_tile(4, 1) == TILE_CRATE);
+    assert(get_screen_char(1, 1 + SCREEN_TOP_MARGIN) == TILE_PLAYER);
+    assert(get_screen_char(2, 1 + SCREEN_TOP_MARGIN) == TILE_CRATE);
+    printf("✓ Moves update the map but not the screen\n");
+
+    set_render_enabled(1);
+    assert(flush_dirty_cells() == 0);
+    draw_level();
+    for (x = 0; x < 7; x++) {
+        assert(get_screen_char(x, 1 + SCREEN_TOP_MARGIN) == get_tile(x, 1));
+    }
+    execute_moves("r");
+    assert(get_screen_char(5, 1 + SCREEN_TOP_MARGIN) == TILE_CRATE);
+    printf("✓ draw_level catches the screen up and rendering resumes\n");
+
+    printf("\n✓ TEST PASSED: Headless Mode\n");
+}
+
+// Test case: Restart puts the loaded level back and redraws only changes
+void test_restart_level(void) {
+    byte x, y, changed = 0;
+    char start[4][9];
+    GameState* state;
+
+    const char* dup_door_level[] = {
+        "#########",
+        "#p.?.#!.#",
+        "#.k.d...#",
+        "#########"
+    };
+
+    printf("\n\n========================================\n");
+    printf("TEST: Restart Level\n");
+    printf("========================================\n");
+
+    my_clrscr();
+    load_level(dup_door_level, 4);
+    draw_level();
+    state = get_game_state();
+    state->current_level = 3;
+    for (y = 0; y < 4; y++) {
+        for (x = 0; x < 9; x++) {
+            start[y][x] = get_tile(x, y);
+        }
+    }
+
+    execute_moves("rrlldrr");  // Duplicate, then open the door
+    assert(state->num_players == 2);
+    assert(get_tile(4, 2) != TILE_DOOR);
+    for (y = 0; y < 4; y++) {
+        for (x = 0; x < 9; x++) {
+            changed += get_tile(x, y) != start[y][x];
+        }
+    }
+
+    restart_level();
+    assert(state->num_players == 1 && state->num_objects == 1);
+    assert(state->level_complete == 0 && state->current_level == 3);
+    verify_entity_index();
+    for (y = 0; y < 4; y++) {
+        for (x = 0; x < 9; x++) {
+            assert(get_tile(x, y) == start[y][x]);
+        }
+    }
+    printf("✓ Restart restores the loaded position\n");
+
+    assert(flush_dirty_cells() == changed);
+    for (y = 0; y < 4; y++) {
+        for (x = 0; x < 9; x++) {
+            assert(get_screen_char(x, y + SCREEN_TOP_MARGIN) == start[y][x]);
+        }
+    }
+    printf("✓ Only the %d changed cells were redrawn\n", changed);
+
+    execute_moves("rr");  // The hole still duplicates after a restart
+    assert(state->num_players == 2);
+    printf("✓ Duplication tracking starts over\n");
+
+    printf("\n✓ TEST PASSED: Restart Level\n");
+}
+
+// Test case: Packed levels load the same as their row strings
+void test_packed_levels(void) {
+    char rows[MAX_LEVEL_HEIGHT][MAX_LEVEL_WIDTH];
+    GameState parsed;
+    byte level, x, y;
+
+    printf("\n\n========================================\n");
+    printf("TEST: Packed Levels\n");
+    printf("========================================\n");
+
+    assert(NUM_PACKED_LEVELS == NUM_LEVELS);
+    for (level = 0; level < NUM_LEVELS; level++) {
+        load_level(levels[level], MAX_LEVEL_HEIGHT);
+        parsed = *get_game_state();
+        for (y = 0; y < MAX_LEVEL_HEIGHT; y++) {
+            for (x = 0; x < MAX_LEVEL_WIDTH; x++) {
+                rows[y][x] = get_tile(x, y);
+            }
+        }
+
+        load_packed_level(packed_levels[level]);
+        assert(memcmp(get_game_state(), &parsed, sizeof(parsed)) == 0);
+        for (y = 0; y < MAX_LEVEL_HEIGHT; y++) {
+            for (x = 0; x < MAX_LEVEL_WIDTH; x++) {
+                assert(get_tile(x, y) == rows[y][x]);
+            }
+        }
+        verify_entity_index();
+    }
+    printf("✓ All %d packed levels match load_level\n", NUM_LEVELS);
+
+    printf("\n✓ TEST PASSED: Packed Levels\n");
+}
+
+#ifdef ENGINE_HASH
+// The incremental hash must match one recomputed from the level map
+static void assert_hash_current(void) {
+    state_hash hash = get_state_hash();
+
+    reset_duplication_tracking();
+    assert(get_state_hash() == hash);
+}
+
+// Test case: The board hash follows every map change
+void test_state_hash(void) {
+    state_hash start_hash;
+
+    const char* door_level[] = {
+        "########",
+        "#p.k.d.#",
+        "#####d##",
+        "########"
+    };
+
+    printf("\n\n========================================\n");
+    printf("TEST: State Hash\n");
+    printf("========================================\n");
+
+    load_level(door_level, 4);
+    start_hash = get_state_hash();
+
+    try_move_player(1, 0);
+    assert(get_state_hash() != start_hash);
+    assert_hash_current();
+    try_move_player(-1, 0);
+    assert(get_state_hash() == start_hash);
+    printf("✓ Same board, same hash\n");
+
+    try_move_player(1, 0);
+    try_move_player(1, 0);
+    assert_hash_current();
+    try_move_player(1, 0);  // Key opens both door cells
+    assert(get_tile(5, 1) == TILE_FLOOR);
+    assert(get_tile(5, 2) == TILE_FLOOR);
+    assert_hash_current();
+    printf("✓ Pushes and door openings update the hash\n");
+
+    set_tile(6, 1, TILE_CRATE);
+    assert(get_state_hash() != start_hash);
+    assert_hash_current();
+    printf("✓ set_tile updates the hash\n");
+
+    printf("\n✓ TEST PASSED: State Hash\n");
+}
+
+// Test case: Packed replays round-trip and replay to the same state
+void test_packed_replay(void) {
+    const char* moves = "r r U l d d R";
+    uint8_t packed[4];
+    uint8_t* read_back = NULL;
+    size_t capacity = 0;
+    char letters[8];
+    ReplayHeader header, loaded;
+    state_hash played;
+    FILE* f;
+    uint32_t i;
+
+    printf("\n\n========================================\n");
+    printf("TEST: Packed Replay\n");
+    printf("========================================\n");
+
+    assert(replay_pack(moves, packed) == 7);
+    assert(REPLAY_BYTES(7) == 2);
+    replay_unpack(packed, 7, letters);
+    assert(strcmp(letters, "rrulddr") == 0);
+    assert(replay_pack("r x", packed) == -1);
+    printf("✓ 7 moves pack into 2 bytes and unpack to the same letters\n");
+
+    load_level(test_level_with_key, 6);
+    execute_moves(moves);
+    played = get_state_hash();
+
+    load_level(test_level_with_key, 6);
+    replay_pack(moves, packed);
+    for (i = 0; i < 7; i++) {
+        byte d = REPLAY_MOVE(packed, i);
+        try_move_player(replay_dx[d], replay_dy[d]);
+    }
+    assert(get_state_hash() == played);
+    printf("✓ Packed moves reach the same state as execute_moves\n");
+
+    header.level = 1;
+    header.flags = 0;
+    header.moves = 7;
+    header.hash = played;
+    f = tmpfile();
+    assert(f != NULL);
+    assert(replay_write(f, &header, packed));
+    rewind(f);
+    assert(replay_read(f, &loaded, &read_back, &capacity) == 1);
+    assert(loaded.level == 1 && loaded.flags == 0 && loaded.moves == 7);
+    assert(loaded.hash == played);
+    assert(memcmp(read_back, packed, 2) == 0);
+    assert(replay_read(f, &loaded, &read_back, &capacity) == 0);
+    fclose(f);
+    free(read_back);
+    printf("✓ A record reads back as written\n");
+
+    printf("\n✓ TEST PASSED: Packed Replay\n");
+}
+#endif
+
+#ifdef ENGINE_UNDO
+#define UNDO_ROWS   6
+#define UNDO_COLS   11
+#define UNDO_MOVES  10
+
+typedef struct {
+    char tiles[UNDO_ROWS][UNDO_COLS];
+    byte num_players;
+    byte num_objects;
+#ifdef ENGINE_HASH
+    state_hash hash;
+#endif
+} UndoSnapshot;
+
+static void take_snapshot(UndoSnapshot* snap) {
+    byte x, y;
+
+    for (y = 0; y < UNDO_ROWS; y++) {
+        for (x = 0; x < UNDO_COLS; x++) {
+            snap->tiles[y][x] = get_tile(x, y);
+        }
+    }
+    snap->num_players = get_game_state()->num_players;
+    snap->num_objects = get_game_state()->num_objects;
+#ifdef ENGINE_HASH
+    snap->hash = get_state_hash();
+#endif
+}
+
+static void assert_snapshot(const UndoSnapshot* snap) {
+    UndoSnapshot now;
+
+    take_snapshot(&now);
+    assert(memcmp(now.tiles, snap->tiles, sizeof(now.tiles)) == 0);
+    assert(now.num_players == snap->num_players);
+    assert(now.num_objects == snap->num_objects);
+#ifdef ENGINE_HASH
+    assert(now.hash == snap->hash);
+#endif
+    verify_entity_index();
+}
+
+// Test case: Undo walks back duplication, an enemy kill and a door opening
+void test_undo_timeline(void) {
+    // Two moves duplicate onto '!' and the enemy kills the copy; the
+    // next five push the key into the door
+    const char* moves = "rrlldrrdrr";
+    const char* undo_level[] = {
+        "###########",
+        "#p.?.#.!..#",
+        "#.k.d.....#",
+        "#.........#",
+        "#......e..#",
+        "###########"
+    };
+    UndoSnapshot before[UNDO_MOVES + 1];
+    char step[2] = { 0, 0 };
+    int i;
+
+    printf("\n\n========================================\n");
+    printf("TEST: Undo Timeline\n");
+    printf("========================================\n");
+
+    load_level(undo_level, UNDO_ROWS);
+    try_move_player(0, -1);  // Into the wall: not a turn
+    assert(undo_turn() == 0);
+    assert(redo_turn() == 0);
+    for (i = 0; i < UNDO_MOVES; i++) {
+        take_snapshot(&before[i]);
+        step[0] = moves[i];
+        execute_moves(step);
+    }
+    take_snapshot(&before[UNDO_MOVES]);
+    assert(before[2].num_players == 1 && get_tile(7, 1) == TILE_ENEMY);  // Copy killed
+    assert(before[UNDO_MOVES].num_objects == 1 && get_tile(4, 2) == TILE_FLOOR);  // Door open
+
+    for (i = UNDO_MOVES - 1; i >= 0; i--) {
+        assert(undo_turn() == 1);
+        assert_snapshot(&before[i]);
+    }
+    assert(undo_turn() == 0);
+    assert(get_tile(7, 4) == TILE_ENEMY && get_tile(4, 2) == TILE_DOOR);
+    printf("✓ Every turn undoes back to the level start\n");
+
+    for (i = 1; i <= UNDO_MOVES; i++) {
+        assert(redo_turn() == 1);
+        assert_snapshot(&before[i]);
+    }
+    assert(redo_turn() == 0);
+    printf("✓ Redo replays the undone turns\n");
+
+    for (i = 0; i < 3; i++) {
+        undo_turn();
+    }
+    try_move_player(-1, 0);  // Not the undone move
+    assert(redo_turn() == 0);
+    assert(undo_turn() == 1);
+    assert_snapshot(&before[UNDO_MOVES - 3]);
+    printf("✓ A different move drops the undone turns\n");
+
+    printf("\n✓ TEST PASSED: Undo Timeline\n");
+}
+#endif
+
+#ifdef ENGINE_REENTRANT
+// Test case: Engine contexts don't share state
+void test_engine_contexts(void) {
+    static EngineContext a, b;
+
+    printf("\n\n========================================\n");
+    printf("TEST: Engine Contexts\n");
+    printf("========================================\n");
+
+    load_level(test_level_with_key, 6);
+
+    // Headless, so neither game touches the shared screen
+    engine_set_render_enabled(&a, 0);
+    engine_set_render_enabled(&b, 0);
+    engine_load_level(&a, test_level_simple, 6);
+    engine_load_level(&b, test_level_simple, 6);
+
+    assert(engine_try_move_player(&a, 1, 0) == 1);
+    assert(engine_get_tile(&a, 9, 3) == TILE_PLAYER);
+    assert(engine_get_tile(&b, 8, 3) == TILE_PLAYER);
+    assert(engine_get_tile(&b, 9, 3) == TILE_FLOOR);
+    assert(engine_get_game_state(&a)->cell[0] == CELL(9, 3));
+    assert(engine_get_game_state(&b)->cell[0] == CELL(8, 3));
+    printf("✓ Moving in one context leaves the other alone\n");
+
+    assert(get_tile(12, 3) == TILE_KEY);
+    assert(get_game_state()->num_objects == 1);
+    printf("✓ Default context keeps its own level\n");
+
+    printf("\n✓ TEST PASSED: Engine Contexts\n");
+}
+#endif
+
 // Main test runner
 int main(void) {
     printf("========================================\n");
@@ -664,9 +1218,26 @@ int main(void) {
     test_key_door();
     test_hole_duplication();
     test_gate_plate();
+    test_gate_crate_plate();
     test_three_players_horizontal();
     test_players_and_keys_line();  // Test mixed players and keys
     test_key_pushed_off_hole();  // Test duplication only on entry
+    test_entity_index_tracking();  // Test occupancy index maintenance
+    test_enemy_target_order();  // Test that removals keep the table order
+    test_dirty_cell_flush();  // Test deferred screen updates
+    test_headless_mode();  // Test simulation without drawing
+    test_restart_level();  // Test restart from the loaded position
+    test_packed_levels();  // Test the compiled level format
+#ifdef ENGINE_HASH
+    test_state_hash();  // Test incremental board hashing
+    test_packed_replay();  // Test the 2-bit replay format
+#endif
+#ifdef ENGINE_UNDO
+    test_undo_timeline();  // Test undo and redo of recorded turns
+#endif
+#ifdef ENGINE_REENTRANT
+    test_engine_contexts();  // Test independent engine instances
+#endif
 
     printf("\n\n========================================\n");
     printf("ALL TESTS PASSED!\n");
@@ -0,0 +1,225 @@
+/*
+  level_compiler.c - Compile the 16x16 levels into the packed level format
+
+  The levels in duplicator_levels_16x16.h are arrays of row strings: a
+  pointer and a terminated string per row, plus the levels[] table. This
+  host tool packs each level for load_packed_level():
+
+    offset  size  field
+         0     1  width
+         1     1  height
+         2     -  wall/floor runs in row-major order, a nibble each (low
+                  nibble first, the last byte padded): 0-15 cells of the
+                  current kind, starting with wall. A run shorter than 15
+                  switches to the other kind, so a run of 15 or more is
+                  written as 15s and the rest, and a level starting with
+                  floor starts with a run of 0.
+         -     1  number of other tiles
+         -    2n  (cell, tile) pairs in row-major order: the map cell
+                  (see CELL) and the level character ('p', 'k', '!', ...)
+
+  Every packed level is loaded back with load_packed_level() and compared,
+  context against context, with load_level() on the source rows before
+  anything is written. The tool writes the packed header (stdout, or
+  --output FILE) and reports on stderr the bytes each level takes in
+  both forms, the bytes saved, and the work the decoder does per level.
+  The decoder's 6502 cycles are measured by duplicator_bench.c (the
+  "unpack" column of build_bench.sh).
+
+  Usage: ./level_compiler [--output FILE]
+*/
+
+#include "duplicator_game.h"
+#include "duplicator_levels_16x16.h"
+#include "test_conio.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_PACKED  (2 + MAP_CELLS + 1 + 2 * 255)  // Longest possible level
+#define MAX_PAIRS   255
+#define ROW_POINTER 2    // Bytes per pointer on the 6502
+#define BYTES_LINE  16   // Bytes per line of the generated header
+
+typedef struct {
+    byte data[MAX_PACKED];
+    int length;
+    int nibbles;         // Wall/floor runs read by the decoder
+    int pairs;           // (cell, tile) pairs
+    int source_bytes;    // Row strings, row pointers and the levels[] entry
+} PackedLevel;
+
+static PackedLevel packed[NUM_LEVELS];
+
+// Contexts the unpacked and parsed levels are compared in
+static EngineContext parsed, unpacked;
+
+static void fail(int level, const char* message) {
+    fprintf(stderr, "level_%d: %s\n", level + 1, message);
+    exit(1);
+}
+
+static void put_nibble(PackedLevel* p, byte nibble) {
+    if ((p->nibbles & 1) == 0) {
+        p->data[p->length++] = nibble;
+    } else {
+        p->data[p->length - 1] |= (byte)(nibble << 4);
+    }
+    p->nibbles++;
+}
+
+// Write one run of walls or floor
+static void put_run(PackedLevel* p, int run, int last) {
+    while (run >= 15) {
+        put_nibble(p, 15);
+        run -= 15;
+    }
+    // A run that ended on a 15 needs a 0 to switch kind, unless nothing follows
+    if (run > 0 || !last) {
+        put_nibble(p, (byte)run);
+    }
+}
+
+static void pack_level(int level, const char** rows, PackedLevel* p) {
+    int x, y, width, height = MAX_LEVEL_HEIGHT;
+    int run = 0, wall = 1, is_wall;
+    int count_at;
+
+    width = (int)strlen(rows[0]);
+    if (width > MAX_LEVEL_WIDTH) {
+        fail(level, "too wide");
+    }
+    p->length = 0;
+    p->nibbles = 0;
+    p->pairs = 0;
+    p->source_bytes = height * ((width + 1) + ROW_POINTER) + ROW_POINTER;
+    p->data[p->length++] = (byte)width;
+    p->data[p->length++] = (byte)height;
+
+    for (y = 0; y < height; y++) {
+        if ((int)strlen(rows[y]) != width) {
+            fail(level, "rows differ in length");
+        }
+        for (x = 0; x < width; x++) {
+            is_wall = rows[y][x] == TILE_WALL;
+            if (is_wall != wall) {
+                put_run(p, run, 0);
+                run = 0;
+                wall = is_wall;
+            }
+            run++;
+        }
+    }
+    put_run(p, run, 1);
+
+    count_at = p->length++;
+    for (y = 0; y < height; y++) {
+        for (x = 0; x < width; x++) {
+            if (rows[y][x] != TILE_WALL && rows[y][x] != TILE_FLOOR) {
+                if (p->pairs == MAX_PAIRS) {
+                    fail(level, "too many tiles besides walls and floor");
+                }
+                p->data[p->length++] = (byte)CELL(x, y);
+                p->data[p->length++] = (byte)rows[y][x];
+                p->pairs++;
+            }
+        }
+    }
+    p->data[count_at] = (byte)p->pairs;
+}
+
+static void check_level(int level, const PackedLevel* p) {
+    memset(&parsed, 0, sizeof(parsed));
+    memset(&unpacked, 0, sizeof(unpacked));
+    engine_set_render_enabled(&parsed, 0);
+    engine_set_render_enabled(&unpacked, 0);
+    engine_load_level(&parsed, levels[level], MAX_LEVEL_HEIGHT);
+    engine_load_packed_level(&unpacked, p->data);
+    if (memcmp(&parsed, &unpacked, sizeof(parsed)) != 0) {
+        fail(level, "unpacks differently from its rows");
+    }
+}
+
+static void write_header(FILE* f) {
+    int level, i;
+
+    fprintf(f, "/*\n");
+    fprintf(f, "  Duplicator Game - Packed Level Data for 16x16 Mode\n\n");
+    fprintf(f, "  Generated from duplicator_levels_16x16.h by test/level_compiler.c;\n");
+    fprintf(f, "  edit the levels there and run test/build_level_compiler.sh.\n");
+    fprintf(f, "  Each level is loaded with load_packed_level(packed_levels[n]).\n");
+    fprintf(f, "*/\n\n");
+    fprintf(f, "#ifndef DUPLICATOR_LEVELS_16X16_PACKED_H\n");
+    fprintf(f, "#define DUPLICATOR_LEVELS_16X16_PACKED_H\n\n");
+
+    for (level = 0; level < NUM_LEVELS; level++) {
+        fprintf(f, "const unsigned char packed_level_%d[] = {", level + 1);
+        for (i = 0; i < packed[level].length; i++) {
+            fprintf(f, "%s0x%02X", i % BYTES_LINE == 0 ? "\n    " : " ", packed[level].data[i]);
+            if (i + 1 < packed[level].length) {
+                fputc(',', f);
+            }
+        }
+        fprintf(f, "\n};\n\n");
+    }
+
+    fprintf(f, "const unsigned char* const packed_levels[] = {\n");
+    for (level = 0; level < NUM_LEVELS; level++) {
+        fprintf(f, "    packed_level_%d%s\n", level + 1, level + 1 < NUM_LEVELS ? "," : "");
+    }
+    fprintf(f, "};\n\n");
+    fprintf(f, "#define NUM_PACKED_LEVELS %d\n\n", NUM_LEVELS);
+    fprintf(f, "#endif // DUPLICATOR_LEVELS_16X16_PACKED_H\n");
+}
+
+static void print_report(void) {
+    int level, source_total = 0, packed_total = 0;
+
+    fprintf(stderr, "level  rows  packed  nibbles  pairs\n");
+    for (level = 0; level < NUM_LEVELS; level++) {
+        fprintf(stderr, "%5d %5d %7d %8d %6d\n", level + 1, packed[level].source_bytes,
+                packed[level].length + ROW_POINTER, packed[level].nibbles, packed[level].pairs);
+        source_total += packed[level].source_bytes;
+        packed_total += packed[level].length + ROW_POINTER;
+    }
+    fprintf(stderr, "Level data: %d bytes as rows, %d packed, %d saved (%d%%)\n",
+            source_total, packed_total, source_total - packed_total,
+            (source_total - packed_total) * 100 / source_total);
+}
+
+static void print_usage(const char* name) {
+    printf("Usage: %s [--output FILE]\n", name);
+    printf("  --output FILE  Write the packed level header to FILE (default stdout)\n");
+}
+
+int main(int argc, char* argv[]) {
+    const char* output = NULL;
+    FILE* f = stdout;
+    int i, level;
+
+    for (i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--output") == 0) {
+            output = argv[++i];
+        } else {
+            print_usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    for (level = 0; level < NUM_LEVELS; level++) {
+        pack_level(level, levels[level], &packed[level]);
+        check_level(level, &packed[level]);
+    }
+
+    if (output != NULL && (f = fopen(output, "w")) == NULL) {
+        perror(output);
+        return 1;
+    }
+    write_header(f);
+    if (f != stdout && fclose(f) != 0) {
+        perror(output);
+        return 1;
+    }
+    print_report();
+    return 0;
+}
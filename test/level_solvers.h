@@ -0,0 +1,62 @@
+/*
+  level_solvers.h - Library entry points of the host solvers
+
+  duplicator_solver.c and sokoban_solver.c are standalone tools; built
+  with SOLVER_LIBRARY defined they leave out main() and can be linked
+  together into another tool (see level_validator.c).
+*/
+
+#ifndef LEVEL_SOLVERS_H
+#define LEVEL_SOLVERS_H
+
+#include <stddef.h>
+
+// Limits for one level (0 = no limit)
+typedef struct {
+    double max_seconds;     // Wall time
+    size_t max_bytes;       // Search memory (nodes, visited set, frontier)
+    size_t max_states;      // States stored
+    int threads;            // Worker threads (duplicator solver only; 0 = 1)
+} SolverBudget;
+
+typedef enum {
+    SOLVER_SOLVED,
+    SOLVER_UNSOLVABLE,      // Searched everything, no solution
+    SOLVER_BUDGET,          // Gave up at a limit
+    SOLVER_INVALID,         // Not a playable level (size, no player, too many boxes)
+    SOLVER_REPLAY_FAILED    // The solution doesn't win on a normally loaded level
+} SolverStatus;
+
+typedef struct {
+    SolverStatus status;
+    unsigned length;        // Optimal length: moves (Duplicator) or pushes (Sokoban)
+    unsigned moves;         // Moves of the reported solution
+    size_t nodes;           // States expanded
+    size_t peak_bytes;      // Most search memory in use
+    double seconds;         // Wall time
+    char* solution;         // Move string (caller frees), NULL unless solved
+} SolverReport;
+
+/*
+  Find a shortest Duplicator solution (BFS, see duplicator_solver.c)
+
+  @param rows - Level rows in the format load_level takes
+  @param num_rows - Number of rows
+  @param budget - Limits for this level
+  @param report - Filled with the result
+*/
+void duplicator_solve(const char* rows[], unsigned char num_rows,
+                      const SolverBudget* budget, SolverReport* report);
+
+/*
+  Find a push-optimal Sokoban solution (A*, see sokoban_solver.c)
+
+  @param rows - Level rows in the format load_level takes
+  @param num_rows - Number of rows
+  @param budget - Limits for this level (threads is ignored)
+  @param report - Filled with the result
+*/
+void sokoban_solve(const char* rows[], unsigned char num_rows,
+                   const SolverBudget* budget, SolverReport* report);
+
+#endif // LEVEL_SOLVERS_H
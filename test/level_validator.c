@@ -0,0 +1,387 @@
+/*
+  level_validator.c - Solve every shipped level pack and report the results
+
+  The Duplicator levels are shipped in several places (the 8x8 game, the
+  16x16 level header, its combined export and the level editor) and the
+  Sokoban levels in three front ends. This host tool loads every level of
+  every pack, runs the matching solver (duplicator_solver.c or
+  sokoban_solver.c, linked as libraries) with a time and memory budget,
+  and writes one CSV row per level:
+
+    game,pack,level,rows_hash,status,length,moves,nodes,peak_kb,wall_ms
+
+  rows_hash is an FNV-1a hash of the level rows, so copies of a level that
+  drifted apart show up as different hashes. A level identical to one
+  already solved is not searched again; its row repeats the earlier
+  results, except for a wall_ms of 0, so summing the column counts every
+  search once. The wall_ms column is the one to compare across solver
+  and engine changes.
+
+  A summary goes to stderr, with the levels whose copies differ between
+  packs. The exit code is 1 if a level couldn't be loaded by its solver
+  or a solution failed its replay.
+
+  Usage: ./level_validator [--time S] [--memory MB] [--states N]
+                           [--threads N] [--output FILE]
+*/
+
+#include "level_solvers.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+
+#define MAX_LEVELS 256
+#define MAX_ROWS   64
+
+typedef enum {
+    GAME_DUPLICATOR,
+    GAME_SOKOBAN
+} Game;
+
+typedef enum {
+    FORMAT_SOURCE,      // C arrays: const char* level_N[] = { "row", ... };
+    FORMAT_EDITOR       // Level editor: const rawLvls = [ ["row", ...], ... ];
+} Format;
+
+typedef struct {
+    Game game;
+    Format format;
+    const char* file;
+} Pack;
+
+typedef struct {
+    const Pack* pack;
+    char name[32];
+    char* rows[MAX_ROWS];
+    unsigned char num_rows;
+    uint32_t hash;
+    SolverReport report;
+    int copy_of;        // Index of the identical level already solved, or -1
+} Level;
+
+// Paths are relative to test/, like the other host tools
+static const Pack packs[] = {
+    { GAME_DUPLICATOR, FORMAT_SOURCE, "../duplicator_levels_16x16.h" },
+    { GAME_DUPLICATOR, FORMAT_SOURCE, "../duplicator8/duplicator.c" },
+    { GAME_DUPLICATOR, FORMAT_SOURCE, "../duplicator_16x16_combined.txt" },
+    { GAME_DUPLICATOR, FORMAT_EDITOR, "../editor/editor.html" },
+    { GAME_SOKOBAN,    FORMAT_SOURCE, "../sokoban8/sokoban.c" },
+    { GAME_SOKOBAN,    FORMAT_SOURCE, "../sokoban8/sokoban_8x8.c" },
+    { GAME_SOKOBAN,    FORMAT_SOURCE, "../sokoban16/sokoban_16x16.c" },
+    { GAME_SOKOBAN,    FORMAT_SOURCE, "../sokoban_mode6/sokoban_mode6.c" }
+};
+#define NUM_PACKS (sizeof(packs) / sizeof(packs[0]))
+
+static const char* game_names[] = { "duplicator", "sokoban" };
+static const char* status_names[] = { "solved", "unsolvable", "budget", "invalid", "replay_failed" };
+#define NUM_STATUSES 5
+
+static Level levels[MAX_LEVELS];
+static int num_levels;
+
+// ---- Pack input ----
+
+static char* read_file(const char* file) {
+    FILE* f = fopen(file, "rb");
+    char* text;
+    long size;
+    size_t length;
+
+    if (f == NULL) {
+        perror(file);
+        exit(1);
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    text = malloc((size_t)size + 1);
+    if (text == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    length = fread(text, 1, (size_t)size, f);
+    text[length] = '\0';
+    fclose(f);
+    return text;
+}
+
+static Level* new_level(const Pack* pack, const char* name, size_t length) {
+    Level* level;
+
+    if (num_levels == MAX_LEVELS) {
+        fprintf(stderr, "Too many levels (max %d)\n", MAX_LEVELS);
+        exit(1);
+    }
+    level = &levels[num_levels++];
+    memset(level, 0, sizeof(*level));
+    level->pack = pack;
+    level->copy_of = -1;
+    if (length > sizeof(level->name) - 1) {
+        length = sizeof(level->name) - 1;
+    }
+    memcpy(level->name, name, length);
+    level->name[length] = '\0';
+    return level;
+}
+
+// The quoted strings between from and end become the level's rows
+static void add_rows(Level* level, const char* from, const char* end) {
+    const char* p;
+    const char* close;
+    char* row;
+
+    for (p = from; (p = memchr(p, '"', end - p)) != NULL; p = close + 1) {
+        close = memchr(p + 1, '"', end - p - 1);
+        if (close == NULL) {
+            break;
+        }
+        if (level->num_rows == MAX_ROWS) {
+            fprintf(stderr, "%s:%s: more than %d rows\n", level->pack->file, level->name, MAX_ROWS);
+            exit(1);
+        }
+        row = malloc(close - p);
+        if (row == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+        memcpy(row, p + 1, close - p - 1);
+        row[close - p - 1] = '\0';
+        level->rows[level->num_rows++] = row;
+    }
+}
+
+// Every "level_N[] = { ... };" array (other arrays are graphics or tables)
+static void read_source_levels(const Pack* pack, const char* text) {
+    const char* p = text;
+    const char* open;
+    const char* name;
+    const char* end;
+
+    while ((open = strstr(p, "[] = {")) != NULL) {
+        for (name = open; name > text && (name[-1] == '_' || isalnum((unsigned char)name[-1])); name--) {
+        }
+        end = strstr(open, "};");
+        if (end == NULL) {
+            break;
+        }
+        if (strncmp(name, "level_", 6) == 0 && isdigit((unsigned char)name[6])) {
+            add_rows(new_level(pack, name, open - name), open, end);
+        }
+        p = end;
+    }
+}
+
+// The editor's built-in levels: one ["row", ...] per level, numbered from 1
+static void read_editor_levels(const Pack* pack, const char* text) {
+    const char* p = strstr(text, "rawLvls = [");
+    const char* end;
+    const char* close;
+    char name[32];
+    int number = 0;
+
+    if (p == NULL || (end = strstr(p, "];")) == NULL) {
+        fprintf(stderr, "%s: no rawLvls table\n", pack->file);
+        exit(1);
+    }
+    p += strlen("rawLvls = [");
+    while ((p = memchr(p, '[', end - p)) != NULL && (close = memchr(p, ']', end - p)) != NULL) {
+        snprintf(name, sizeof(name), "level_%d", ++number);
+        add_rows(new_level(pack, name, strlen(name)), p, close);
+        p = close + 1;
+    }
+}
+
+static void read_pack(const Pack* pack) {
+    char* text = read_file(pack->file);
+    int first = num_levels;
+
+    if (pack->format == FORMAT_EDITOR) {
+        read_editor_levels(pack, text);
+    } else {
+        read_source_levels(pack, text);
+    }
+    if (num_levels == first) {
+        fprintf(stderr, "%s: no levels found\n", pack->file);
+        exit(1);
+    }
+    free(text);
+}
+
+// FNV-1a over the rows, each followed by a newline
+static uint32_t hash_rows(const Level* level) {
+    uint32_t hash = 2166136261u;
+    const char* c;
+    unsigned char y;
+
+    for (y = 0; y < level->num_rows; y++) {
+        for (c = level->rows[y]; *c != '\0'; c++) {
+            hash = (hash ^ (unsigned char)*c) * 16777619u;
+        }
+        hash = (hash ^ '\n') * 16777619u;
+    }
+    return hash;
+}
+
+static int same_rows(const Level* a, const Level* b) {
+    unsigned char y;
+
+    if (a->num_rows != b->num_rows) {
+        return 0;
+    }
+    for (y = 0; y < a->num_rows; y++) {
+        if (strcmp(a->rows[y], b->rows[y]) != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// ---- Solving ----
+
+static void solve(Level* level, const SolverBudget* budget) {
+    const char** rows = (const char**)level->rows;
+    int i;
+
+    // Identical copies (same game) are solved once
+    for (i = 0; &levels[i] != level; i++) {
+        if (levels[i].copy_of < 0 && levels[i].pack->game == level->pack->game
+                && levels[i].hash == level->hash && same_rows(&levels[i], level)) {
+            level->copy_of = i;
+            level->report = levels[i].report;
+            level->report.solution = NULL;
+            return;
+        }
+    }
+    if (level->pack->game == GAME_DUPLICATOR) {
+        duplicator_solve(rows, level->num_rows, budget, &level->report);
+    } else {
+        sokoban_solve(rows, level->num_rows, budget, &level->report);
+    }
+}
+
+static void write_row(FILE* out, const Level* level) {
+    const SolverReport* r = &level->report;
+    int solved = r->status == SOLVER_SOLVED;
+
+    fprintf(out, "%s,%s,%s,%08lx,%s,", game_names[level->pack->game], level->pack->file,
+            level->name, (unsigned long)level->hash, status_names[r->status]);
+    if (solved) {
+        fprintf(out, "%u,%u,", r->length, r->moves);
+    } else {
+        fprintf(out, ",,");
+    }
+    fprintf(out, "%lu,%lu,%.0f\n", (unsigned long)r->nodes,
+            (unsigned long)((r->peak_bytes + 1023) / 1024),
+            level->copy_of < 0 ? r->seconds * 1000.0 : 0.0);
+    fflush(out);
+}
+
+// ---- Summary ----
+
+static void print_summary(void) {
+    int counts[2][NUM_STATUSES];
+    double seconds = 0;
+    int i, j, game, status, differ = 0;
+
+    memset(counts, 0, sizeof(counts));
+    for (i = 0; i < num_levels; i++) {
+        counts[levels[i].pack->game][levels[i].report.status]++;
+        if (levels[i].copy_of < 0) {
+            seconds += levels[i].report.seconds;
+        }
+    }
+    for (game = 0; game < 2; game++) {
+        fprintf(stderr, "%-10s", game_names[game]);
+        for (status = 0; status < NUM_STATUSES; status++) {
+            fprintf(stderr, "  %s %d", status_names[status], counts[game][status]);
+        }
+        fprintf(stderr, "\n");
+    }
+    fprintf(stderr, "%d levels in %d packs, %.2fs solving\n", num_levels, (int)NUM_PACKS, seconds);
+
+    // Same name and game, different rows: the packs have drifted apart
+    for (i = 0; i < num_levels; i++) {
+        for (j = 0; j < i; j++) {
+            if (levels[j].pack->game == levels[i].pack->game
+                    && strcmp(levels[j].name, levels[i].name) == 0) {
+                if (levels[j].hash != levels[i].hash) {
+                    fprintf(stderr, "%s differs: %s (%08lx) vs %s (%08lx)\n", levels[i].name,
+                            levels[j].pack->file, (unsigned long)levels[j].hash,
+                            levels[i].pack->file, (unsigned long)levels[i].hash);
+                    differ++;
+                }
+                break;
+            }
+        }
+    }
+    if (differ == 0) {
+        fprintf(stderr, "All copies of a level match\n");
+    }
+}
+
+static void print_usage(const char* name) {
+    printf("Usage: %s [--time S] [--memory MB] [--states N] [--threads N] [--output FILE]\n", name);
+    printf("  --time S       Give up on a level after S seconds (default 10, 0 = no limit)\n");
+    printf("  --memory MB    Give up on a level above MB of search memory (default 512)\n");
+    printf("  --states N     Give up on a level after N states (default no limit)\n");
+    printf("  --threads N    Duplicator solver threads (default 1)\n");
+    printf("  --output FILE  Write the CSV report to FILE (default stdout)\n");
+}
+
+int main(int argc, char* argv[]) {
+    SolverBudget budget;
+    FILE* out = stdout;
+    const char* output = NULL;
+    size_t p;
+    int i, failed = 0;
+
+    budget.max_seconds = 10;
+    budget.max_bytes = (size_t)512 << 20;
+    budget.max_states = 0;
+    budget.threads = 1;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--time") == 0 && i + 1 < argc) {
+            budget.max_seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--memory") == 0 && i + 1 < argc) {
+            budget.max_bytes = (size_t)strtoul(argv[++i], NULL, 10) << 20;
+        } else if (strcmp(argv[i], "--states") == 0 && i + 1 < argc) {
+            budget.max_states = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            budget.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            print_usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    for (p = 0; p < NUM_PACKS; p++) {
+        read_pack(&packs[p]);
+    }
+    if (output != NULL && (out = fopen(output, "w")) == NULL) {
+        perror(output);
+        return 1;
+    }
+
+    fprintf(out, "game,pack,level,rows_hash,status,length,moves,nodes,peak_kb,wall_ms\n");
+    for (i = 0; i < num_levels; i++) {
+        levels[i].hash = hash_rows(&levels[i]);
+        solve(&levels[i], &budget);
+        write_row(out, &levels[i]);
+        if (levels[i].report.status == SOLVER_INVALID
+                || levels[i].report.status == SOLVER_REPLAY_FAILED) {
+            failed = 1;
+        }
+        free(levels[i].report.solution);
+    }
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    print_summary();
+    return failed;
+}
@@ -0,0 +1,98 @@
+/*
+  replay_format.c - Packed replay records (see replay_format.h)
+*/
+
+#include "replay_format.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char replay_magic[4] = { 'D', 'R', 'P', '1' };
+
+const char replay_letters[4] = { 'u', 'd', 'l', 'r' };
+const signed char replay_dx[4] = { 0, 0, -1, 1 };
+const signed char replay_dy[4] = { -1, 1, 0, 0 };
+
+long replay_pack(const char* moves, uint8_t* packed) {
+    long count = 0;
+    int code;
+
+    for (; *moves != '\0'; moves++) {
+        switch (*moves) {
+            case 'u': case 'U': code = 0; break;
+            case 'd': case 'D': code = 1; break;
+            case 'l': case 'L': code = 2; break;
+            case 'r': case 'R': code = 3; break;
+            case ' ': continue;
+            default: return -1;
+        }
+        if ((count & 3) == 0) {
+            packed[count >> 2] = 0;
+        }
+        packed[count >> 2] |= (uint8_t)(code << ((count & 3) << 1));
+        count++;
+    }
+    return count;
+}
+
+void replay_unpack(const uint8_t* packed, uint32_t count, char* moves) {
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        moves[i] = replay_letters[REPLAY_MOVE(packed, i)];
+    }
+    moves[count] = '\0';
+}
+
+int replay_write(FILE* f, const ReplayHeader* header, const uint8_t* packed) {
+    uint8_t bytes[REPLAY_HEADER_SIZE];
+    int i;
+
+    memcpy(bytes, replay_magic, 4);
+    bytes[4] = header->level;
+    bytes[5] = header->flags;
+    bytes[6] = 0;
+    bytes[7] = 0;
+    for (i = 0; i < 4; i++) {
+        bytes[8 + i] = (uint8_t)(header->moves >> (i * 8));
+    }
+    for (i = 0; i < 8; i++) {
+        bytes[12 + i] = (uint8_t)(header->hash >> (i * 8));
+    }
+    return fwrite(bytes, 1, REPLAY_HEADER_SIZE, f) == REPLAY_HEADER_SIZE
+        && fwrite(packed, 1, REPLAY_BYTES(header->moves), f) == REPLAY_BYTES(header->moves);
+}
+
+int replay_read(FILE* f, ReplayHeader* header, uint8_t** packed, size_t* capacity) {
+    uint8_t bytes[REPLAY_HEADER_SIZE];
+    size_t length = fread(bytes, 1, REPLAY_HEADER_SIZE, f);
+    uint8_t* grown;
+    int i;
+
+    if (length == 0) {
+        return 0;
+    }
+    if (length != REPLAY_HEADER_SIZE || memcmp(bytes, replay_magic, 4) != 0) {
+        return -1;
+    }
+    header->level = bytes[4];
+    header->flags = bytes[5];
+    header->moves = 0;
+    for (i = 3; i >= 0; i--) {
+        header->moves = (header->moves << 8) | bytes[8 + i];
+    }
+    header->hash = 0;
+    for (i = 7; i >= 0; i--) {
+        header->hash = (header->hash << 8) | bytes[12 + i];
+    }
+
+    length = REPLAY_BYTES(header->moves);
+    if (length > *capacity) {
+        grown = realloc(*packed, length);
+        if (grown == NULL) {
+            return -1;
+        }
+        *packed = grown;
+        *capacity = length;
+    }
+    return fread(*packed, 1, length, f) == length ? 1 : -1;
+}
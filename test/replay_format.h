@@ -0,0 +1,90 @@
+/*
+  replay_format.h - Packed replay records (2 bits per move)
+
+  A replay file is a sequence of records, each a 20-byte header followed
+  by the moves:
+
+    offset  size  field
+         0     4  magic "DRP1"
+         4     1  level id (1-based index into levels[] of
+                  duplicator_levels_16x16.h)
+         5     1  flags (REPLAY_COMPLETE: the level is complete at the end)
+         6     2  reserved (0)
+         8     4  number of moves, little-endian
+        12     8  expected get_state_hash() after the last move,
+                  little-endian (the 64-bit host hash)
+        20     -  moves, 4 per byte, the first move in the low 2 bits
+
+  Move codes follow the letters of execute_moves(): 0 = 'u', 1 = 'd',
+  2 = 'l', 3 = 'r'. There is no code for "no move".
+*/
+
+#ifndef REPLAY_FORMAT_H
+#define REPLAY_FORMAT_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define REPLAY_HEADER_SIZE 20
+#define REPLAY_COMPLETE    0x01
+
+// Bytes taken by n packed moves
+#define REPLAY_BYTES(n) (((size_t)(n) + 3) / 4)
+
+// Code of move i in a packed move array
+#define REPLAY_MOVE(packed, i) (((packed)[(i) >> 2] >> (((i) & 3) << 1)) & 3)
+
+typedef struct {
+    uint8_t level;          // 1-based level id
+    uint8_t flags;          // REPLAY_COMPLETE
+    uint32_t moves;         // Number of moves
+    uint64_t hash;          // Expected state hash after the last move
+} ReplayHeader;
+
+// Move letter and direction of each move code
+extern const char replay_letters[4];
+extern const signed char replay_dx[4];
+extern const signed char replay_dy[4];
+
+/*
+  Pack a move string (spaces are skipped)
+
+  @param moves - Letters 'u', 'd', 'l', 'r' (either case)
+  @param packed - Receives the packed moves (REPLAY_BYTES(strlen(moves)) bytes)
+  @return Number of moves, or -1 if the string has another character
+*/
+long replay_pack(const char* moves, uint8_t* packed);
+
+/*
+  Unpack moves into letters
+
+  @param packed - Packed moves
+  @param count - Number of moves
+  @param moves - Receives count letters and a terminating '\0'
+*/
+void replay_unpack(const uint8_t* packed, uint32_t count, char* moves);
+
+/*
+  Write one record
+
+  @param f - Output file
+  @param header - Record header
+  @param packed - header->moves packed moves
+  @return 1 on success, 0 on a write error
+*/
+int replay_write(FILE* f, const ReplayHeader* header, const uint8_t* packed);
+
+/*
+  Read the next record, growing the move buffer as needed
+
+  @param f - Input file
+  @param header - Receives the record header
+  @param packed - Move buffer (may be NULL), reallocated to fit
+  @param capacity - Size of *packed in bytes, updated on reallocation
+  @return 1 for a record, 0 at the end of the file, -1 if the file is
+          truncated, has a bad magic or runs out of memory
+*/
+int replay_read(FILE* f, ReplayHeader* header, uint8_t** packed, size_t* capacity);
+
+#endif // REPLAY_FORMAT_H
@@ -0,0 +1,297 @@
+/*
+  replay_runner.c - Verify packed replays against the engine
+
+  Streams the records of one or more replay files (replay_format.h)
+  through the engine, headless on its own context: each record loads its
+  level from duplicator_levels_16x16.h, plays the moves and compares the
+  state hash (ENGINE_HASH) and level completion with the ones recorded.
+  It reports the records and moves played, the mismatches, and moves per
+  second.
+
+  With --record it writes a corpus instead: fixed-seed random walks over
+  every level (stopping when the level is complete or every player is
+  gone), plus the move strings of a --solutions file, each with the hash
+  the current engine ends on. Record a corpus before an engine change and
+  replay it after to catch changes in behavior.
+
+  Usage: ./replay_runner FILE ...
+         ./replay_runner --record FILE [--walks N] [--length N] [--seed N]
+                         [--solutions FILE]
+*/
+
+#include "duplicator_game.h"
+#include "duplicator_levels_16x16.h"
+#include "test_conio.h"
+#include "replay_format.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_REPORTED 10     // Mismatches printed in full
+#define MAX_LINE     4096   // Longest --solutions line
+
+// Game being replayed
+static EngineContext game;
+
+// Recording settings
+static int walks = 1000;
+static int walk_length = 200;
+static uint32_t rng_state = 1;
+
+static uint32_t next_random(void) {
+    // xorshift32
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static double seconds_now(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static void* checked_realloc(void* ptr, size_t size) {
+    ptr = realloc(ptr, size);
+    if (ptr == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return ptr;
+}
+
+static void start_level(byte level) {
+    engine_set_render_enabled(&game, 0);
+    engine_load_level(&game, levels[level - 1], MAX_LEVEL_HEIGHT);
+}
+
+static byte level_over(void) {
+    return game.game_state.level_complete || game.game_state.num_players == 0;
+}
+
+// Play packed moves from the level start and fill in the final state
+static void play_record(ReplayHeader* header, const uint8_t* packed) {
+    uint32_t i;
+    byte d;
+
+    start_level(header->level);
+    for (i = 0; i < header->moves; i++) {
+        d = REPLAY_MOVE(packed, i);
+        engine_try_move_player(&game, replay_dx[d], replay_dy[d]);
+    }
+    header->hash = engine_get_state_hash(&game);
+    header->flags = game.game_state.level_complete == 1 ? REPLAY_COMPLETE : 0;
+}
+
+// ---- Recording ----
+
+static void write_record(FILE* f, const char* file, ReplayHeader* header, const uint8_t* packed) {
+    play_record(header, packed);
+    if (!replay_write(f, header, packed)) {
+        perror(file);
+        exit(1);
+    }
+}
+
+// Lines of "LEVEL MOVES" ('#' starts a comment); the moves may be
+// separated by spaces, as execute_moves() accepts them
+static unsigned long record_solutions(FILE* out, const char* file, const char* solutions,
+                                      unsigned long* total_moves) {
+    FILE* f = fopen(solutions, "r");
+    char line[MAX_LINE];
+    char* moves;
+    char* end;
+    uint8_t packed[REPLAY_BYTES(MAX_LINE)];
+    ReplayHeader header;
+    unsigned long records = 0;
+    int line_number = 0;
+    long level, count;
+    size_t length;
+
+    if (f == NULL) {
+        perror(solutions);
+        exit(1);
+    }
+    while (fgets(line, sizeof(line), f) != NULL) {
+        line_number++;
+        length = strlen(line);
+        if (length > 0 && line[length - 1] == '\n') {
+            line[--length] = '\0';
+        } else if (!feof(f)) {
+            fprintf(stderr, "%s:%d: line longer than %d characters\n", solutions, line_number,
+                    MAX_LINE - 2);
+            exit(1);
+        }
+        if (length > 0 && line[length - 1] == '\r') {
+            line[--length] = '\0';
+        }
+        if (line[0] == '#' || line[strspn(line, " \t")] == '\0') {
+            continue;
+        }
+
+        level = strtol(line, &end, 10);
+        moves = end + strspn(end, " \t");
+        count = (end != line && moves != end) ? replay_pack(moves, packed) : -1;
+        if (level < 1 || level > NUM_LEVELS || count <= 0) {
+            fprintf(stderr, "%s:%d: bad level or moves\n", solutions, line_number);
+            exit(1);
+        }
+        header.level = (uint8_t)level;
+        header.moves = (uint32_t)count;
+        write_record(out, file, &header, packed);
+        records++;
+        *total_moves += header.moves;
+    }
+    fclose(f);
+    return records;
+}
+
+static int record(const char* file, const char* solutions) {
+    FILE* f = fopen(file, "wb");
+    uint8_t* packed = checked_realloc(NULL, REPLAY_BYTES(walk_length));
+    ReplayHeader header;
+    unsigned long records = 0, total_moves = 0;
+    long size;
+    byte level;
+    int walk;
+    uint32_t length;
+    byte d;
+
+    if (f == NULL) {
+        perror(file);
+        return 1;
+    }
+    if (solutions != NULL) {
+        records += record_solutions(f, file, solutions, &total_moves);
+    }
+
+    for (level = 1; level <= NUM_LEVELS; level++) {
+        for (walk = 0; walk < walks; walk++) {
+            start_level(level);
+            memset(packed, 0, REPLAY_BYTES(walk_length));
+            for (length = 0; length < (uint32_t)walk_length && !level_over(); length++) {
+                d = next_random() & 3;
+                packed[length >> 2] |= (uint8_t)(d << ((length & 3) << 1));
+                engine_try_move_player(&game, replay_dx[d], replay_dy[d]);
+            }
+            header.level = level;
+            header.moves = length;
+            write_record(f, file, &header, packed);
+            records++;
+            total_moves += length;
+        }
+    }
+    size = ftell(f);
+    if (fclose(f) != 0 || size < 0) {
+        perror(file);
+        return 1;
+    }
+    free(packed);
+    printf("%s: %lu records, %lu moves, %ld bytes\n", file, records, total_moves, size);
+    return 0;
+}
+
+// ---- Verification ----
+
+static unsigned long verify(const char* file, unsigned long* total_moves, unsigned long* mismatches) {
+    static char buffer[1 << 20];
+    static uint8_t* packed;
+    static size_t capacity;
+    FILE* f = fopen(file, "rb");
+    ReplayHeader header, played;
+    unsigned long records = 0;
+    int result;
+
+    if (f == NULL) {
+        perror(file);
+        exit(1);
+    }
+    setvbuf(f, buffer, _IOFBF, sizeof(buffer));
+    while ((result = replay_read(f, &header, &packed, &capacity)) == 1) {
+        if (header.level < 1 || header.level > NUM_LEVELS) {
+            fprintf(stderr, "%s: record %lu has level %d (1-%d)\n", file, records,
+                    header.level, NUM_LEVELS);
+            exit(1);
+        }
+        played = header;
+        play_record(&played, packed);
+        if (played.hash != header.hash || played.flags != header.flags) {
+            if (++*mismatches <= MAX_REPORTED) {
+                printf("%s: record %lu (level %d, %lu moves): hash %016llx%s, expected %016llx%s\n",
+                       file, records, header.level, (unsigned long)header.moves,
+                       (unsigned long long)played.hash, played.flags & REPLAY_COMPLETE ? " complete" : "",
+                       (unsigned long long)header.hash, header.flags & REPLAY_COMPLETE ? " complete" : "");
+            }
+        }
+        records++;
+        *total_moves += header.moves;
+    }
+    if (result < 0) {
+        fprintf(stderr, "%s: bad or truncated record %lu\n", file, records);
+        exit(1);
+    }
+    fclose(f);
+    return records;
+}
+
+static void print_usage(const char* name) {
+    printf("Usage: %s FILE ...\n", name);
+    printf("       %s --record FILE [--walks N] [--length N] [--seed N] [--solutions FILE]\n", name);
+    printf("  FILE ...          Replay every record and check the final state hashes\n");
+    printf("  --record FILE     Write random walks (and solutions) over every level to FILE\n");
+    printf("  --walks N         Random walks per level (default %d)\n", walks);
+    printf("  --length N        Most moves per walk (default %d)\n", walk_length);
+    printf("  --seed N          Random seed (default 1)\n");
+    printf("  --solutions FILE  Also record the \"LEVEL MOVES\" lines of FILE\n");
+}
+
+int main(int argc, char* argv[]) {
+    const char* output = NULL;
+    const char* solutions = NULL;
+    unsigned long records = 0, total_moves = 0, mismatches = 0;
+    double start, elapsed;
+    int i, num_files = 0;
+
+    for (i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--record") == 0) {
+            output = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--walks") == 0) {
+            walks = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--length") == 0) {
+            walk_length = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--seed") == 0) {
+            rng_state = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (i + 1 < argc && strcmp(argv[i], "--solutions") == 0) {
+            solutions = argv[++i];
+        } else if (argv[i][0] == '-') {
+            print_usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        } else {
+            argv[num_files++] = argv[i];
+        }
+    }
+    if (walks < 0 || walk_length < 0 || rng_state == 0
+            || (output == NULL) == (num_files == 0)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    if (output != NULL) {
+        return record(output, solutions);
+    }
+
+    start = seconds_now();
+    for (i = 0; i < num_files; i++) {
+        records += verify(argv[i], &total_moves, &mismatches);
+    }
+    elapsed = seconds_now() - start;
+
+    printf("%lu records, %lu moves, %lu mismatches, %.2fs (%.0f moves/s)\n",
+           records, total_moves, mismatches, elapsed,
+           elapsed > 0 ? total_moves / elapsed : 0.0);
+    return mismatches != 0;
+}
@@ -0,0 +1,939 @@
+/*
+  sokoban_solver.c - Push-optimal solver for the Sokoban levels
+
+  Reads levels in the string format load_level() takes (rows of '#', ' ',
+  '.', '$', '*', '@', '+') and finds a solution with the fewest pushes
+  using A*:
+  - Dead squares are found once per level: a cell is dead when no goal
+    can be reached by pushing a box from it (pulling from every goal
+    backwards, ignoring other boxes). Boxes are never pushed onto them.
+  - A state is the sorted box cells plus the player's reachable region,
+    stored as the lowest cell the player can walk to, so positions that
+    differ only in where the player stands inside a region are one state.
+  - The lower bound is a minimum-cost matching of boxes to goals using
+    the push distances from the dead-square pass (Hungarian algorithm).
+  Every push moves one box one step closer to or further from a goal, so
+  the bound is consistent and the first solution expanded is optimal in
+  pushes. The walks between pushes are shortest paths, but the move count
+  is not minimized over all push-optimal solutions.
+
+  Levels come from game sources (every "const char* name[] = { ... };"
+  string array in the file, so the levels shipped with sokoban8,
+  sokoban16 and sokoban_mode6 are read in place) or from text files with
+  one row per line and levels separated by blank lines. For each level it
+  prints pushes, moves, nodes expanded and nodes per second, and the
+  solution in LURD notation (lowercase walks, uppercase pushes).
+
+  Usage: ./sokoban_solver [--level N] [--max-nodes N] [file ...]
+         (default: the game sources in ../sokoban8, ../sokoban16 and
+         ../sokoban_mode6)
+
+  Built with SOLVER_LIBRARY, main() and the level readers are left out
+  and sokoban_solve() (level_solvers.h) solves any level with a time and
+  memory budget.
+*/
+
+#include "sokoban_game.h"
+#include "level_solvers.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <time.h>
+
+#define MAX_WIDTH   (COLS + 2)          // Level plus a wall border
+#define MAX_HEIGHT  (ROWS + 2)
+#define MAX_CELLS   (MAX_WIDTH * MAX_HEIGHT)
+#define MAX_BOXES   32
+#define MAX_LEVELS  64
+#define INFINITE    0xFFFF
+#define NO_NODE     UINT32_MAX
+
+// Directions in LURD order
+static const char walk_letters[4] = { 'l', 'u', 'r', 'd' };
+static const char push_letters[4] = { 'L', 'U', 'R', 'D' };
+
+typedef struct {
+    char name[64];
+    char rows[ROWS][COLS + 1];
+    byte num_rows;
+} Level;
+
+// Search node; its state (box cells then player region) is in states[]
+typedef struct {
+    uint32_t parent;
+    uint16_t g;                 // Pushes from the start
+    uint16_t box;               // Cell the pushed box came from
+    byte dir;                   // Direction of that push
+    byte closed;
+} Node;
+
+// Heap entry (lazy deletion: stale entries have g != node's g)
+typedef struct {
+    uint32_t node;
+    uint16_t f;
+    uint16_t g;
+} HeapEntry;
+
+// Level being solved
+static int width, height, num_cells;
+static int dir_step[4];
+static byte wall[MAX_CELLS];
+static byte goal[MAX_CELLS];
+static byte dead[MAX_CELLS];
+static int goals[MAX_BOXES];
+static int num_goals;
+static int num_boxes;
+static uint16_t* push_distance;         // [goal][cell]
+static uint16_t start_boxes[MAX_BOXES];
+static int start_player;
+
+// Search storage
+static Node* nodes;
+static uint16_t* states;
+static size_t num_nodes, nodes_capacity;
+static int state_size;                  // num_boxes + 1
+static uint32_t* table;                 // Open addressing over node ids
+static size_t table_size;
+static HeapEntry* heap;
+static size_t heap_count, heap_capacity;
+
+static size_t max_nodes = 5000000;
+static double max_seconds;              // 0 = no limit
+static size_t max_bytes;                // 0 = no limit
+
+static void* checked_realloc(void* ptr, size_t size) {
+    void* result = realloc(ptr, size);
+    if (result == NULL && size != 0) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return result;
+}
+
+static double seconds_now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static int is_goal_tile(char t) {
+    return t == TILE_GOAL || t == TILE_BOX_ON_GOAL || t == TILE_PLAYER_ON_GOAL;
+}
+
+static int is_box_tile(char t) {
+    return t == TILE_BOX || t == TILE_BOX_ON_GOAL;
+}
+
+static int is_player_tile(char t) {
+    return t == TILE_PLAYER || t == TILE_PLAYER_ON_GOAL;
+}
+
+// ---- Level input ----
+
+#ifndef SOLVER_LIBRARY
+static Level levels[MAX_LEVELS];
+static int num_levels;
+
+static Level* new_level(const char* file, const char* name) {
+    Level* level;
+
+    if (num_levels == MAX_LEVELS) {
+        fprintf(stderr, "Too many levels (max %d)\n", MAX_LEVELS);
+        exit(1);
+    }
+    level = &levels[num_levels++];
+    memset(level, 0, sizeof(*level));
+    snprintf(level->name, sizeof(level->name), "%s:%s", file, name);
+    return level;
+}
+
+static void add_row(Level* level, const char* row, size_t length) {
+    if (level->num_rows == ROWS || length > COLS) {
+        fprintf(stderr, "%s: level larger than %dx%d\n", level->name, COLS, ROWS);
+        exit(1);
+    }
+    memcpy(level->rows[level->num_rows], row, length);
+    level->rows[level->num_rows][length] = '\0';
+    level->num_rows++;
+}
+
+// Every "name[] = { "row", ... };" string array in a C source
+static void read_source_levels(const char* file, const char* text) {
+    const char* p = text;
+    const char* open;
+    const char* end;
+    const char* name;
+    char label[32];
+    size_t length;
+    Level* level;
+
+    while ((open = strstr(p, "[] = {")) != NULL) {
+        for (name = open; name > text && (name[-1] == '_' || isalnum((unsigned char)name[-1])); name--) {
+        }
+        length = (size_t)(open - name) < sizeof(label) - 1 ? (size_t)(open - name) : sizeof(label) - 1;
+        memcpy(label, name, length);
+        label[length] = '\0';
+        end = strstr(open, "};");
+        if (end == NULL) {
+            break;
+        }
+
+        level = new_level(file, label);
+        for (p = open; (p = memchr(p, '"', end - p)) != NULL; p++) {
+            const char* close = memchr(p + 1, '"', end - p - 1);
+            if (close == NULL) {
+                break;
+            }
+            add_row(level, p + 1, close - p - 1);
+            p = close;
+        }
+        if (level->num_rows == 0) {
+            num_levels--;  // Some other string array
+        }
+        p = end;
+    }
+}
+
+// Plain text: one row per line, blank lines between levels, ';' comments
+static void read_text_levels(const char* file, const char* text) {
+    const char* p = text;
+    const char* eol;
+    size_t length;
+    Level* level = NULL;
+    char label[16];
+
+    while (*p) {
+        eol = strchr(p, '\n');
+        length = eol ? (size_t)(eol - p) : strlen(p);
+        while (length > 0 && (p[length - 1] == '\r' || p[length - 1] == ' ')) {
+            length--;
+        }
+        if (length == 0 || p[0] == ';') {
+            level = NULL;
+        } else {
+            if (level == NULL) {
+                snprintf(label, sizeof(label), "%d", num_levels + 1);
+                level = new_level(file, label);
+            }
+            add_row(level, p, length);
+        }
+        p = eol ? eol + 1 : p + length;
+    }
+}
+
+static void read_levels(const char* file) {
+    FILE* f = fopen(file, "rb");
+    char* text;
+    long size;
+    size_t length;
+
+    if (f == NULL) {
+        perror(file);
+        exit(1);
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    text = checked_realloc(NULL, (size_t)size + 1);
+    length = fread(text, 1, (size_t)size, f);
+    text[length] = '\0';
+    fclose(f);
+
+    length = strlen(file);
+    if (length > 2 && strcmp(file + length - 2, ".c") == 0) {
+        read_source_levels(file, text);
+    } else {
+        read_text_levels(file, text);
+    }
+    free(text);
+}
+#endif
+
+// ---- Per-level tables ----
+
+// Parse a level; returns 0 if it can't be played (no player, bad counts)
+static int setup_level(const Level* level) {
+    int x, y, cell, d, g;
+    int queue[MAX_CELLS], head, tail;
+    byte inside[MAX_CELLS];
+    char t;
+    int player = -1;
+
+    width = 0;
+    for (y = 0; y < level->num_rows; y++) {
+        if ((int)strlen(level->rows[y]) > width) {
+            width = (int)strlen(level->rows[y]);
+        }
+    }
+    width += 2;
+    height = level->num_rows + 2;
+    num_cells = width * height;
+    dir_step[0] = -1;
+    dir_step[1] = -width;
+    dir_step[2] = 1;
+    dir_step[3] = width;
+
+    memset(wall, 1, sizeof(wall));
+    memset(goal, 0, sizeof(goal));
+    num_boxes = 0;
+    num_goals = 0;
+    for (y = 0; y < level->num_rows; y++) {
+        for (x = 0; level->rows[y][x]; x++) {
+            cell = (y + 1) * width + x + 1;
+            t = level->rows[y][x];
+            wall[cell] = (t == TILE_WALL);
+            if (is_goal_tile(t)) {
+                goal[cell] = 1;
+                if (num_goals == MAX_BOXES) {
+                    return 0;
+                }
+                goals[num_goals++] = cell;
+            }
+            if (is_box_tile(t)) {
+                if (num_boxes == MAX_BOXES) {
+                    return 0;
+                }
+                start_boxes[num_boxes++] = (uint16_t)cell;
+            }
+            if (is_player_tile(t)) {
+                player = cell;
+            }
+        }
+    }
+    if (player < 0) {
+        return 0;
+    }
+
+    // Whatever the player can't walk to (ignoring boxes) is wall
+    memset(inside, 0, sizeof(inside));
+    head = tail = 0;
+    queue[tail++] = player;
+    inside[player] = 1;
+    while (head < tail) {
+        cell = queue[head++];
+        for (d = 0; d < 4; d++) {
+            int next = cell + dir_step[d];
+            if (!wall[next] && !inside[next]) {
+                inside[next] = 1;
+                queue[tail++] = next;
+            }
+        }
+    }
+    for (cell = 0; cell < num_cells; cell++) {
+        if (!inside[cell]) {
+            wall[cell] = 1;
+        }
+    }
+    start_player = player;
+
+    // Push distance from every cell to every goal: pull a box backwards
+    // from the goal; a pull to box+d needs the player at box+2d
+    push_distance = checked_realloc(push_distance, (size_t)num_goals * num_cells * sizeof(uint16_t));
+    memset(dead, 1, sizeof(dead));
+    for (g = 0; g < num_goals; g++) {
+        uint16_t* dist = &push_distance[(size_t)g * num_cells];
+
+        for (cell = 0; cell < num_cells; cell++) {
+            dist[cell] = INFINITE;
+        }
+        head = tail = 0;
+        queue[tail++] = goals[g];
+        dist[goals[g]] = 0;
+        while (head < tail) {
+            cell = queue[head++];
+            dead[cell] = 0;
+            for (d = 0; d < 4; d++) {
+                int next = cell + dir_step[d];
+                int behind = next + dir_step[d];
+
+                if (!wall[next] && behind >= 0 && behind < num_cells && !wall[behind]
+                        && dist[next] == INFINITE) {
+                    dist[next] = dist[cell] + 1;
+                    queue[tail++] = next;
+                }
+            }
+        }
+    }
+    return 1;
+}
+
+#ifndef SOLVER_LIBRARY
+static int count_dead_squares(void) {
+    int cell, count = 0;
+
+    for (cell = 0; cell < num_cells; cell++) {
+        if (!wall[cell] && dead[cell]) {
+            count++;
+        }
+    }
+    return count;
+}
+#endif
+
+// ---- Lower bound ----
+
+// Minimum-cost assignment of boxes to distinct goals by push distance
+// (Hungarian algorithm, boxes as rows); INFINITE if some box is stuck
+static unsigned matching_bound(const uint16_t* boxes) {
+    int u[MAX_BOXES + 1], v[MAX_BOXES + 1], way[MAX_BOXES + 1], match[MAX_BOXES + 1];
+    int min_to[MAX_BOXES + 1];
+    byte used[MAX_BOXES + 1];
+    int i, j, j0, j1, i0, delta, cost;
+    unsigned total = 0;
+
+    memset(u, 0, sizeof(u));
+    memset(v, 0, sizeof(v));
+    memset(match, 0, sizeof(match));
+    for (i = 1; i <= num_boxes; i++) {
+        match[0] = i;
+        j0 = 0;
+        for (j = 0; j <= num_goals; j++) {
+            min_to[j] = INT32_MAX;
+            used[j] = 0;
+        }
+        do {
+            used[j0] = 1;
+            i0 = match[j0];
+            delta = INT32_MAX;
+            j1 = 0;
+            for (j = 1; j <= num_goals; j++) {
+                if (!used[j]) {
+                    cost = push_distance[(size_t)(j - 1) * num_cells + boxes[i0 - 1]];
+                    cost = cost == INFINITE ? 1000000 : cost;
+                    cost -= u[i0] + v[j];
+                    if (cost < min_to[j]) {
+                        min_to[j] = cost;
+                        way[j] = j0;
+                    }
+                    if (min_to[j] < delta) {
+                        delta = min_to[j];
+                        j1 = j;
+                    }
+                }
+            }
+            for (j = 0; j <= num_goals; j++) {
+                if (used[j]) {
+                    u[match[j]] += delta;
+                    v[j] -= delta;
+                } else {
+                    min_to[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while (match[j0] != 0);
+        do {
+            j1 = way[j0];
+            match[j0] = match[j1];
+            j0 = j1;
+        } while (j0);
+    }
+
+    for (j = 1; j <= num_goals; j++) {
+        if (match[j]) {
+            cost = push_distance[(size_t)(j - 1) * num_cells + boxes[match[j] - 1]];
+            if (cost == INFINITE) {
+                return INFINITE;
+            }
+            total += cost;
+        }
+    }
+    return total;
+}
+
+// ---- Search state ----
+
+// Cells the player can walk to; returns the lowest (the region's name)
+static int player_region(const uint16_t* boxes, int player, byte* reach) {
+    int queue[MAX_CELLS], head = 0, tail = 0;
+    int cell, next, d, lowest = player;
+    byte box_at[MAX_CELLS];
+    int i;
+
+    memset(box_at, 0, (size_t)num_cells);
+    for (i = 0; i < num_boxes; i++) {
+        box_at[boxes[i]] = 1;
+    }
+    memset(reach, 0, (size_t)num_cells);
+    reach[player] = 1;
+    queue[tail++] = player;
+    while (head < tail) {
+        cell = queue[head++];
+        if (cell < lowest) {
+            lowest = cell;
+        }
+        for (d = 0; d < 4; d++) {
+            next = cell + dir_step[d];
+            if (!wall[next] && !box_at[next] && !reach[next]) {
+                reach[next] = 1;
+                queue[tail++] = next;
+            }
+        }
+    }
+    return lowest;
+}
+
+static uint64_t hash_state(const uint16_t* state) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    int i;
+
+    for (i = 0; i < state_size; i++) {
+        hash ^= state[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+static uint16_t* node_state(uint32_t n) {
+    return &states[(size_t)n * state_size];
+}
+
+static void table_insert(uint32_t n) {
+    size_t i = (size_t)hash_state(node_state(n)) & (table_size - 1);
+
+    while (table[i] != NO_NODE) {
+        i = (i + 1) & (table_size - 1);
+    }
+    table[i] = n;
+}
+
+static void table_grow(void) {
+    size_t i;
+
+    table_size = table_size ? table_size * 2 : 1 << 16;
+    table = checked_realloc(table, table_size * sizeof(uint32_t));
+    for (i = 0; i < table_size; i++) {
+        table[i] = NO_NODE;
+    }
+    for (i = 0; i < num_nodes; i++) {
+        table_insert((uint32_t)i);
+    }
+}
+
+static uint32_t table_find(const uint16_t* state) {
+    size_t i = (size_t)hash_state(state) & (table_size - 1);
+
+    while (table[i] != NO_NODE) {
+        if (memcmp(node_state(table[i]), state, state_size * sizeof(uint16_t)) == 0) {
+            return table[i];
+        }
+        i = (i + 1) & (table_size - 1);
+    }
+    return NO_NODE;
+}
+
+static uint32_t add_node(const uint16_t* state, uint32_t parent, uint16_t g, int box, int dir) {
+    if (num_nodes == nodes_capacity) {
+        nodes_capacity = nodes_capacity ? nodes_capacity * 2 : 1 << 16;
+        nodes = checked_realloc(nodes, nodes_capacity * sizeof(Node));
+        states = checked_realloc(states, nodes_capacity * state_size * sizeof(uint16_t));
+    }
+    memcpy(node_state((uint32_t)num_nodes), state, state_size * sizeof(uint16_t));
+    nodes[num_nodes].parent = parent;
+    nodes[num_nodes].g = g;
+    nodes[num_nodes].box = (uint16_t)box;
+    nodes[num_nodes].dir = (byte)dir;
+    nodes[num_nodes].closed = 0;
+    num_nodes++;
+    if (num_nodes * 2 > table_size) {
+        table_grow();
+    } else {
+        table_insert((uint32_t)(num_nodes - 1));
+    }
+    return (uint32_t)(num_nodes - 1);
+}
+
+// Lower f first; on ties the deeper node (closer to a solution)
+static int heap_before(const HeapEntry* a, const HeapEntry* b) {
+    return a->f < b->f || (a->f == b->f && a->g > b->g);
+}
+
+static void heap_push(uint32_t node, unsigned f, unsigned g) {
+    size_t i;
+    HeapEntry entry;
+
+    if (heap_count == heap_capacity) {
+        heap_capacity = heap_capacity ? heap_capacity * 2 : 1 << 16;
+        heap = checked_realloc(heap, heap_capacity * sizeof(HeapEntry));
+    }
+    entry.node = node;
+    entry.f = (uint16_t)f;
+    entry.g = (uint16_t)g;
+    for (i = heap_count++; i > 0 && heap_before(&entry, &heap[(i - 1) / 2]); i = (i - 1) / 2) {
+        heap[i] = heap[(i - 1) / 2];
+    }
+    heap[i] = entry;
+}
+
+static HeapEntry heap_pop(void) {
+    HeapEntry top = heap[0];
+    HeapEntry last = heap[--heap_count];
+    size_t i = 0, child;
+
+    while ((child = 2 * i + 1) < heap_count) {
+        if (child + 1 < heap_count && heap_before(&heap[child + 1], &heap[child])) {
+            child++;
+        }
+        if (!heap_before(&heap[child], &last)) {
+            break;
+        }
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = last;
+    return top;
+}
+
+// Bytes held by the search (what max_bytes limits)
+static size_t memory_in_use(void) {
+    return nodes_capacity * (sizeof(Node) + state_size * sizeof(uint16_t))
+        + table_size * sizeof(uint32_t) + heap_capacity * sizeof(HeapEntry)
+        + (size_t)num_goals * num_cells * sizeof(uint16_t);
+}
+
+// Give the memory of the last search back (the state size differs per level)
+static void release_search(void) {
+    free(nodes);
+    free(states);
+    free(table);
+    free(heap);
+    nodes = NULL;
+    states = NULL;
+    table = NULL;
+    heap = NULL;
+    nodes_capacity = 0;
+    table_size = 0;
+    heap_capacity = 0;
+}
+
+static void sort_boxes(uint16_t* boxes) {
+    int i, j;
+    uint16_t b;
+
+    for (i = 1; i < num_boxes; i++) {
+        b = boxes[i];
+        for (j = i; j > 0 && boxes[j - 1] > b; j--) {
+            boxes[j] = boxes[j - 1];
+        }
+        boxes[j] = b;
+    }
+}
+
+static int all_on_goals(const uint16_t* boxes) {
+    int i;
+
+    for (i = 0; i < num_boxes; i++) {
+        if (!goal[boxes[i]]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+typedef enum { SOLVED, UNSOLVABLE, LIMIT } SolveResult;
+
+// A* over pushes; on SOLVED the goal node is stored in *goal_node
+static SolveResult solve(uint32_t* goal_node, size_t* expanded, size_t* peak_bytes) {
+    double start = seconds_now();
+    uint16_t state[MAX_BOXES + 1], child[MAX_BOXES + 1];
+    byte reach[MAX_CELLS], child_reach[MAX_CELLS];
+    byte box_at[MAX_CELLS];
+    HeapEntry top;
+    uint32_t n, found;
+    unsigned h, g;
+    int i, d, box, target;
+
+    release_search();
+    num_nodes = 0;
+    heap_count = 0;
+    state_size = num_boxes + 1;
+    table_grow();
+    *expanded = 0;
+    *peak_bytes = 0;
+
+    // Fewer goals than boxes, or a box on a dead square: never solvable
+    if (num_boxes > num_goals) {
+        return UNSOLVABLE;
+    }
+    memcpy(state, start_boxes, num_boxes * sizeof(uint16_t));
+    sort_boxes(state);
+    state[num_boxes] = (uint16_t)player_region(state, start_player, reach);
+    h = matching_bound(state);
+    if (h == INFINITE) {
+        return UNSOLVABLE;
+    }
+    heap_push(add_node(state, NO_NODE, 0, 0, 0), h, 0);
+
+    while (heap_count > 0) {
+        top = heap_pop();
+        n = top.node;
+        if (nodes[n].closed || top.g != nodes[n].g) {
+            continue;  // Stale entry
+        }
+        if (all_on_goals(node_state(n))) {
+            *goal_node = n;
+            return SOLVED;
+        }
+        nodes[n].closed = 1;
+        (*expanded)++;
+        if (num_nodes > max_nodes) {
+            return LIMIT;
+        }
+        if ((*expanded & 1023) == 0) {
+            if (memory_in_use() > *peak_bytes) {
+                *peak_bytes = memory_in_use();
+            }
+            if ((max_bytes && *peak_bytes > max_bytes)
+                    || (max_seconds && seconds_now() - start > max_seconds)) {
+                return LIMIT;
+            }
+        }
+
+        memcpy(state, node_state(n), state_size * sizeof(uint16_t));
+        player_region(state, state[num_boxes], reach);
+        memset(box_at, 0, (size_t)num_cells);
+        for (i = 0; i < num_boxes; i++) {
+            box_at[state[i]] = 1;
+        }
+        g = nodes[n].g + 1;
+
+        for (i = 0; i < num_boxes; i++) {
+            box = state[i];
+            for (d = 0; d < 4; d++) {
+                target = box + dir_step[d];
+                if (!reach[box - dir_step[d]] || wall[target] || box_at[target] || dead[target]) {
+                    continue;
+                }
+
+                // Box moves to target, the player to where the box was
+                memcpy(child, state, state_size * sizeof(uint16_t));
+                child[i] = (uint16_t)target;
+                sort_boxes(child);
+                child[num_boxes] = (uint16_t)player_region(child, box, child_reach);
+
+                found = table_find(child);
+                if (found != NO_NODE) {
+                    if (nodes[found].closed || nodes[found].g <= g) {
+                        continue;
+                    }
+                    // Shorter way to a state still waiting in the heap
+                    nodes[found].g = (uint16_t)g;
+                    nodes[found].parent = n;
+                    nodes[found].box = (uint16_t)box;
+                    nodes[found].dir = (byte)d;
+                    heap_push(found, g + matching_bound(child), g);
+                    continue;
+                }
+
+                h = matching_bound(child);
+                if (h == INFINITE) {
+                    continue;
+                }
+                heap_push(add_node(child, n, (uint16_t)g, box, d), g + h, g);
+            }
+        }
+    }
+    return UNSOLVABLE;
+}
+
+// ---- Solution ----
+
+// Shortest walk from 'from' to 'to' avoiding boxes, appended as letters
+static size_t walk_path(const byte* box_at, int from, int to, char* out) {
+    int queue[MAX_CELLS], came[MAX_CELLS], head = 0, tail = 0;
+    byte seen[MAX_CELLS];
+    char path[MAX_CELLS];
+    int cell, next, d, length = 0;
+    size_t i;
+
+    memset(seen, 0, (size_t)num_cells);
+    seen[from] = 1;
+    queue[tail++] = from;
+    while (head < tail && !seen[to]) {
+        cell = queue[head++];
+        for (d = 0; d < 4; d++) {
+            next = cell + dir_step[d];
+            if (!wall[next] && !box_at[next] && !seen[next]) {
+                seen[next] = 1;
+                came[next] = d;
+                queue[tail++] = next;
+            }
+        }
+    }
+    for (cell = to; cell != from; cell -= dir_step[came[cell]]) {
+        path[length++] = walk_letters[came[cell]];
+    }
+    for (i = 0; i < (size_t)length; i++) {
+        out[i] = path[length - 1 - i];
+    }
+    return (size_t)length;
+}
+
+// Rebuild the LURD string; returns its length (moves), pushes in *pushes
+static size_t build_solution(uint32_t goal_node, char** out, unsigned* pushes) {
+    uint32_t chain[INFINITE];
+    byte box_at[MAX_CELLS];
+    size_t length = 0, capacity = 1024;
+    int count = 0, i, player = start_player, box, d;
+    uint32_t n;
+    char* text = checked_realloc(NULL, capacity);
+
+    for (n = goal_node; nodes[n].parent != NO_NODE; n = nodes[n].parent) {
+        chain[count++] = n;
+    }
+    memset(box_at, 0, (size_t)num_cells);
+    for (i = 0; i < num_boxes; i++) {
+        box_at[start_boxes[i]] = 1;
+    }
+
+    for (i = count - 1; i >= 0; i--) {
+        box = nodes[chain[i]].box;
+        d = nodes[chain[i]].dir;
+        if (length + num_cells + 2 > capacity) {
+            capacity = 2 * capacity + num_cells;
+            text = checked_realloc(text, capacity);
+        }
+        length += walk_path(box_at, player, box - dir_step[d], text + length);
+        text[length++] = push_letters[d];
+        box_at[box] = 0;
+        box_at[box + dir_step[d]] = 1;
+        player = box;
+    }
+    text[length] = '\0';
+    *out = text;
+    *pushes = (unsigned)count;
+    return length;
+}
+
+void sokoban_solve(const char* rows[], unsigned char num_rows,
+                   const SolverBudget* budget, SolverReport* report) {
+    double start = seconds_now();
+    static Level level;
+    uint32_t goal_node;
+    SolveResult result;
+    size_t bytes;
+    byte y;
+
+    memset(report, 0, sizeof(*report));
+    memset(&level, 0, sizeof(level));
+    if (num_rows > ROWS) {
+        report->status = SOLVER_INVALID;
+        return;
+    }
+    for (y = 0; y < num_rows; y++) {
+        if (strlen(rows[y]) > COLS) {
+            report->status = SOLVER_INVALID;
+            return;
+        }
+        strcpy(level.rows[y], rows[y]);
+    }
+    level.num_rows = num_rows;
+    if (!setup_level(&level)) {
+        report->status = SOLVER_INVALID;
+        return;
+    }
+
+    max_nodes = budget->max_states ? budget->max_states : SIZE_MAX;
+    max_seconds = budget->max_seconds;
+    max_bytes = budget->max_bytes;
+
+    result = solve(&goal_node, &report->nodes, &report->peak_bytes);
+    bytes = memory_in_use();
+    if (bytes > report->peak_bytes) {
+        report->peak_bytes = bytes;
+    }
+    if (result == SOLVED) {
+        report->moves = (unsigned)build_solution(goal_node, &report->solution, &report->length);
+        report->status = SOLVER_SOLVED;
+    } else {
+        report->status = result == UNSOLVABLE ? SOLVER_UNSOLVABLE : SOLVER_BUDGET;
+    }
+    release_search();
+    report->seconds = seconds_now() - start;
+}
+
+#ifndef SOLVER_LIBRARY
+static void print_usage(const char* name) {
+    printf("Usage: %s [--level N] [--max-nodes N] [file ...]\n", name);
+    printf("  --level N      Only solve the Nth level read (default all)\n");
+    printf("  --max-nodes N  Give up on a level after N nodes (default %lu)\n",
+           (unsigned long)max_nodes);
+    printf("  file           Game source (.c, its level string arrays) or text levels\n");
+    printf("                 (default: the sokoban8, sokoban16 and sokoban_mode6 games)\n");
+}
+
+int main(int argc, char* argv[]) {
+    static const char* default_files[] = {
+        "../sokoban8/sokoban.c",
+        "../sokoban16/sokoban_16x16.c",
+        "../sokoban_mode6/sokoban_mode6.c"
+    };
+    int only_level = 0, files = 0;
+    int i, l;
+    uint32_t goal_node;
+    size_t expanded, peak_bytes, moves;
+    unsigned pushes;
+    char* solution;
+    double start, elapsed;
+    SolveResult result;
+
+    for (i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--level") == 0) {
+            only_level = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--max-nodes") == 0) {
+            max_nodes = strtoul(argv[++i], NULL, 10);
+        } else if (argv[i][0] == '-') {
+            print_usage(argv[0]);
+            return 1;
+        } else {
+            read_levels(argv[i]);
+            files++;
+        }
+    }
+    if (files == 0) {
+        for (i = 0; i < (int)(sizeof(default_files) / sizeof(default_files[0])); i++) {
+            read_levels(default_files[i]);
+        }
+    }
+    if (only_level < 0 || only_level > num_levels || max_nodes == 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    for (l = 0; l < num_levels; l++) {
+        if (only_level && l + 1 != only_level) {
+            continue;
+        }
+        printf("Level %d (%s): ", l + 1, levels[l].name);
+        if (!setup_level(&levels[l])) {
+            printf("not a playable level\n");
+            continue;
+        }
+
+        start = seconds_now();
+        result = solve(&goal_node, &expanded, &peak_bytes);
+        elapsed = seconds_now() - start;
+        if (elapsed <= 0) {
+            elapsed = 1e-9;
+        }
+
+        if (result == SOLVED) {
+            moves = build_solution(goal_node, &solution, &pushes);
+            printf("%u pushes, %lu moves\n  %s\n", pushes, (unsigned long)moves, solution);
+            free(solution);
+        } else if (result == UNSOLVABLE) {
+            printf("unsolvable (%d boxes, %d goals)\n", num_boxes, num_goals);
+        } else {
+            printf("gave up after %lu nodes\n", (unsigned long)max_nodes);
+        }
+        printf("  %d dead squares, %lu nodes expanded, %lu stored, %.2fs (%.0f nodes/s)\n",
+               count_dead_squares(), (unsigned long)expanded, (unsigned long)num_nodes,
+               elapsed, expanded / elapsed);
+    }
+
+    release_search();
+    free(push_distance);
+    return 0;
+}
+#endif
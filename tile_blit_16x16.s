@@ -0,0 +1,105 @@
+;
+; tile_blit_16x16.s - 2x2 character tile blitter for the 16x16 tile modes
+;
+; Each 16x16 tile is 4 consecutive screen codes drawn as a 2x2 block:
+;   tile+0 tile+1    (TILE_TL, TILE_TR)
+;   tile+2 tile+3    (TILE_BL, TILE_BR)
+; Screen code 0 is empty space and is drawn as four zero characters.
+;
+; C prototype (same signature in both games):
+;   void __fastcall__ my_cputcxy_16x16(byte tx, byte ty, byte tile_char);  // duplicator
+;   void __fastcall__ my_put_tile_16x16(byte tx, byte ty, byte tile_tl);   // sokoban16
+;
+; The tile code arrives in A, ty and tx are popped from the C stack.
+; The screen address of the tile row comes from a row-offset table plus
+; the page of the screen being drawn (tile_screen_page, so a redraw can
+; target a hidden buffer) and the 4 stores go through a zero-page pointer
+; with Y as the column.
+;
+; Shared by duplicator_conio_16x16.c and sokoban16/atari_conio_16x16.c;
+; keep the copy in sokoban16/ identical.
+;
+
+        .export _my_cputcxy_16x16
+        .export _my_put_tile_16x16
+        .export _tile_screen_page
+
+        .import popa
+        .importzp ptr1, tmp1
+
+SCREEN_MEM = $9000              ; Must match SCREEN_MEM in the C headers
+CHAR_COLS  = 40
+ROW_BYTES  = 2 * CHAR_COLS      ; One tile row = 2 character rows
+TILE_ROWS  = 13                 ; 12 visible rows + 1 for the last duplicator level row
+
+.data
+
+; High byte of the screen buffer being drawn (buffers are page aligned)
+_tile_screen_page:
+        .byte   >SCREEN_MEM
+
+.rodata
+
+; Offset of the top-left character of each tile row
+row_lo:
+        .repeat TILE_ROWS, I
+        .byte <(I * ROW_BYTES)
+        .endrepeat
+row_hi:
+        .repeat TILE_ROWS, I
+        .byte >(I * ROW_BYTES)
+        .endrepeat
+
+.code
+
+_my_cputcxy_16x16:
+_my_put_tile_16x16:
+        sta     tmp1            ; Tile code
+        jsr     popa            ; ty
+        tax
+        lda     row_lo,x
+        sta     ptr1
+        lda     row_hi,x
+        clc
+        adc     _tile_screen_page
+        sta     ptr1+1
+        jsr     popa            ; tx
+        asl     a               ; Column of the left character = tx * 2
+        tay
+
+        ldx     tmp1
+        beq     empty
+
+        txa
+        sta     (ptr1),y        ; Top-left     (tile + TILE_TL)
+        inx
+        txa
+        iny
+        sta     (ptr1),y        ; Top-right    (tile + TILE_TR)
+        inx
+        tya
+        clc
+        adc     #CHAR_COLS - 1  ; Down one character row, back one column
+        tay
+        txa
+        sta     (ptr1),y        ; Bottom-left  (tile + TILE_BL)
+        inx
+        txa
+        iny
+        sta     (ptr1),y        ; Bottom-right (tile + TILE_BR)
+        rts
+
+empty:
+        lda     #0
+        sta     (ptr1),y        ; Top-left
+        iny
+        sta     (ptr1),y        ; Top-right
+        tya
+        clc
+        adc     #CHAR_COLS - 1
+        tay
+        lda     #0
+        sta     (ptr1),y        ; Bottom-left
+        iny
+        sta     (ptr1),y        ; Bottom-right
+        rts
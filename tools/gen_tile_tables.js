@@ -0,0 +1,293 @@
+#!/usr/bin/env node
+
+/**
+ * gen_tile_tables.js - Generate const tile lookup tables for Duplicator
+ *
+ * Usage: node tools/gen_tile_tables.js
+ *
+ * Reads the tile characters and 16x16 screen codes from
+ * duplicator_tiles_16x16.h and the TILE_CAT_* bits from duplicator_game.h,
+ * then writes:
+ *   duplicator_tile_props.h             - categories, duplication class and
+ *                                         the ENGINE_HASH Zobrist keys
+ *   duplicator8/duplicator_tile_props.h - same tables for the 8x8 build
+ *   duplicator_tile_codes_16x16.h       - tile character -> 16x16 screen code
+ *
+ * Every table has 256 entries so the game looks a tile up with a single
+ * indexed load. Re-run this after changing tiles or the property list below.
+ */
+
+const fs = require('fs');
+const path = require('path');
+
+const rootDir = path.join(__dirname, '..');
+const tilesHeader = fs.readFileSync(path.join(rootDir, 'duplicator_tiles_16x16.h'), 'utf8');
+const gameHeader = fs.readFileSync(path.join(rootDir, 'duplicator_game.h'), 'utf8');
+
+// Tile properties (TILE_CAT_* names without the prefix)
+const TILE_PROPS = {
+    TILE_EMPTY:       ['PASSABLE'],
+    TILE_FLOOR:       ['PASSABLE'],
+    TILE_WALL:        ['BLOCKING'],
+    TILE_PLAYER:      ['BLOCKING'],               // Blocking to other players
+    TILE_CRATE:       ['BLOCKING', 'PUSHABLE'],
+    TILE_KEY:         ['BLOCKING', 'PUSHABLE'],
+    TILE_ENEMY:       ['BLOCKING', 'PUSHABLE'],
+    TILE_DOOR:        ['BLOCKING'],               // Closed
+    TILE_DOOR_OPEN:   ['PASSABLE'],
+    TILE_HOLE_A:      ['PASSABLE', 'HOLE'],
+    TILE_HOLE_B:      ['PASSABLE', 'HOLE'],
+    TILE_HOLE_A_FILL: ['PASSABLE', 'HOLE'],
+    TILE_HOLE_B_FILL: ['PASSABLE', 'HOLE'],
+    TILE_PLATE_A:     ['PASSABLE', 'PLATE'],
+    TILE_PLATE_B:     ['PASSABLE', 'PLATE'],
+    TILE_GATE_A:      ['BLOCKING', 'GATE'],       // Closed
+    TILE_GATE_B:      ['BLOCKING', 'GATE'],       // Closed
+    TILE_GATE_A_OPEN: ['PASSABLE', 'GATE'],
+    TILE_GATE_B_OPEN: ['PASSABLE', 'GATE'],
+    TILE_EXIT_A:      ['PASSABLE', 'EXIT'],
+    TILE_EXIT_B:      ['PASSABLE', 'EXIT'],
+    TILE_EXIT_C:      ['PASSABLE', 'EXIT'],
+    TILE_WALL_LINE_A: ['BLOCKING'],
+    TILE_WALL_LINE_B: ['BLOCKING'],
+    TILE_WALL_LINE_G: ['BLOCKING'],
+    TILE_LINE_A:      ['PASSABLE'],               // Decorative lines
+    TILE_LINE_B:      ['PASSABLE'],
+    TILE_LINE_C:      ['PASSABLE'],
+    TILE_LINE_D:      ['PASSABLE'],
+    TILE_LINE_E:      ['PASSABLE'],
+    TILE_LINE_F:      ['PASSABLE'],
+    TILE_LINE_G:      ['PASSABLE'],
+    TILE_LINE_H:      ['PASSABLE'],
+};
+
+// PuzzleScript: enemystopper = crate or key or enemy or walls or door or gateA_closed or gateB_closed
+// Anything an entity cannot walk onto stops an enemy as well.
+const ENEMY_STOPPERS = ['TILE_CRATE', 'TILE_KEY', 'TILE_ENEMY', 'TILE_DOOR', 'TILE_GATE_A', 'TILE_GATE_B'];
+
+// Duplication classes, in the order handle_duplication resolves them
+const DUP_CLASSES = ['TILE_PLAYER', 'TILE_KEY', 'TILE_CRATE', 'TILE_ENEMY'];
+const DUP_NONE = 0xFF;
+
+// Screen codes that don't follow the TILE_<NAME> -> <NAME> convention
+const SCREEN_CODE_OVERRIDES = {
+    TILE_EMPTY: 0,          // Empty space
+    TILE_PLATE_B: 'PLATE_A' // Plate B uses same graphics as Plate A
+};
+
+// Parse "#define NAME value" lines
+function parseDefines(text, pattern) {
+    const defines = {};
+    for (const match of text.matchAll(pattern)) {
+        defines[match[1]] = match[2];
+    }
+    return defines;
+}
+
+function charValue(literal) {
+    const m = literal.match(/^'(.)'$/);
+    if (!m) {
+        throw new Error(`Unsupported tile character literal ${literal}`);
+    }
+    return m[1].charCodeAt(0);
+}
+
+const tileChars = {};
+for (const [name, literal] of Object.entries(parseDefines(tilesHeader, /#define\s+(TILE_\w+)\s+('.')/g))) {
+    tileChars[name] = charValue(literal);
+}
+const screenCodes = {};
+for (const [name, value] of Object.entries(parseDefines(tilesHeader, /#define\s+([A-Z][A-Z0-9_]*)\s+(0x[0-9A-Fa-f]+)/g))) {
+    screenCodes[name] = parseInt(value, 16);
+}
+const categoryBits = {};
+for (const [name, value] of Object.entries(parseDefines(gameHeader, /#define\s+TILE_CAT_(\w+)\s+(0x[0-9A-Fa-f]+)/g))) {
+    categoryBits[name] = parseInt(value, 16);
+}
+
+function tileChar(name) {
+    if (!(name in tileChars)) {
+        throw new Error(`${name} is not defined in duplicator_tiles_16x16.h`);
+    }
+    return tileChars[name];
+}
+
+function categoryBit(name) {
+    if (!(name in categoryBits)) {
+        throw new Error(`TILE_CAT_${name} is not defined in duplicator_game.h`);
+    }
+    return categoryBits[name];
+}
+
+// Build the tables
+const categories = new Array(256).fill(0);
+const dupClass = new Array(256).fill(DUP_NONE);
+const screen = new Array(256).fill(0);
+const tileNames = new Array(256).fill(null);
+
+for (const [name, props] of Object.entries(TILE_PROPS)) {
+    const c = tileChar(name);
+    tileNames[c] = name;
+    for (const prop of props) {
+        categories[c] |= categoryBit(prop);
+    }
+}
+for (const name of ENEMY_STOPPERS) {
+    categories[tileChar(name)] |= categoryBit('ENEMY_STOP');
+}
+for (let c = 0; c < 256; c++) {
+    if (!(categories[c] & categoryBit('PASSABLE'))) {
+        categories[c] |= categoryBit('ENEMY_STOP');
+    }
+}
+DUP_CLASSES.forEach((name, index) => {
+    dupClass[tileChar(name)] = index;
+});
+for (const name of Object.keys(tileChars)) {
+    let code = name in SCREEN_CODE_OVERRIDES ? SCREEN_CODE_OVERRIDES[name] : name.substring(5);
+    if (typeof code === 'string') {
+        if (!(code in screenCodes)) {
+            throw new Error(`No screen code ${code} for ${name}`);
+        }
+        code = screenCodes[code];
+    }
+    screen[tileChar(name)] = code;
+    tileNames[tileChar(name)] = name;
+}
+
+function hex(value) {
+    return '0x' + value.toString(16).toUpperCase().padStart(2, '0');
+}
+
+// Format a 256-entry table, 16 values per line
+function formatTable(decl, values) {
+    const lines = [`${decl}[256] = {`];
+    for (let row = 0; row < 256; row += 16) {
+        const cells = values.slice(row, row + 16).map(hex).join(', ');
+        const sep = row + 16 < 256 ? ',' : ' ';
+        lines.push(`    ${cells}${sep} // ${hex(row)}`);
+    }
+    lines.push('};');
+    return lines.join('\n');
+}
+
+// List the named entries so the tables can be checked by eye
+function formatLegend(values) {
+    const lines = [];
+    for (let c = 0; c < 256; c++) {
+        if (tileNames[c] && values[c] !== 0 && values[c] !== DUP_NONE) {
+            lines.push(`//   '${String.fromCharCode(c)}' ${tileNames[c].padEnd(17)} ${hex(values[c])}`);
+        }
+    }
+    return lines.join('\n');
+}
+
+// Zobrist keys for ENGINE_HASH: one key per map cell and per 7-bit tile
+// character, drawn from xorshift32. The host takes two draws per 64-bit
+// key, the 32-bit cc65 build one draw per key.
+const gameDefines = parseDefines(gameHeader, /#define\s+(MAX_LEVEL_\w+)\s+(\d+)/g);
+const MAP_CELLS = (Number(gameDefines.MAX_LEVEL_WIDTH) + 1) * (Number(gameDefines.MAX_LEVEL_HEIGHT) + 2);
+const HASH_TILES = 128;
+const HASH_SEED = 0x2545F491;
+
+function xorshift32(seed) {
+    seed = (seed ^ (seed << 13)) >>> 0;
+    seed = (seed ^ (seed >>> 17)) >>> 0;
+    return (seed ^ (seed << 5)) >>> 0;
+}
+
+function hashKeys(drawsPerKey) {
+    const keys = [];
+    let seed = HASH_SEED;
+    for (let i = 0; i < MAP_CELLS + HASH_TILES; i++) {
+        let key = '';
+        for (let d = 0; d < drawsPerKey; d++) {
+            seed = xorshift32(seed);
+            key += seed.toString(16).toUpperCase().padStart(8, '0');
+        }
+        keys.push(`0x${key}${drawsPerKey > 1 ? 'ULL' : 'UL'}`);
+    }
+    return { cells: keys.slice(0, MAP_CELLS), tiles: keys.slice(MAP_CELLS) };
+}
+
+// Format a key table, 4 keys per line
+function formatKeys(decl, keys) {
+    const lines = [`${decl} = {`];
+    for (let i = 0; i < keys.length; i += 4) {
+        const sep = i + 4 < keys.length ? ',' : '';
+        lines.push(`    ${keys.slice(i, i + 4).join(', ')}${sep}`);
+    }
+    lines.push('};');
+    return lines.join('\n');
+}
+
+const hostKeys = hashKeys(2);
+const cc65Keys = hashKeys(1);
+
+const banner = (file, what) => `/* ${file} - ${what}
+ *
+ * GENERATED by tools/gen_tile_tables.js from duplicator_tiles_16x16.h
+ * and duplicator_game.h - do not edit by hand.
+ */`;
+
+const props = `${banner('duplicator_tile_props.h', 'Tile property tables')}
+
+// Include from exactly one source file (duplicator_game.c); the tables
+// are declared extern where other files need them.
+#ifndef DUPLICATOR_TILE_PROPS_H
+#define DUPLICATOR_TILE_PROPS_H
+
+// Duplication classes (index into tile_dup_types)
+#define DUP_CLASSES ${DUP_CLASSES.length}
+#define DUP_NONE    ${hex(DUP_NONE)}  // Tile never duplicates
+
+// Tile type for each duplication class, in resolution order
+const char tile_dup_types[DUP_CLASSES] = { ${DUP_CLASSES.map(n => `'${String.fromCharCode(tileChar(n))}'`).join(', ')} };
+
+// TILE_CAT_* bits for every tile character
+${formatLegend(categories)}
+${formatTable('const byte tile_categories', categories)}
+
+// Duplication class for every tile character (DUP_NONE if it never duplicates)
+${formatTable('const byte tile_dup_class', dupClass)}
+
+#ifdef ENGINE_HASH
+// Zobrist keys (see HASH_KEY in duplicator_game.c): const, so contexts
+// on different threads share them without any setup
+#ifdef __CC65__
+${formatKeys('const state_hash cell_keys[MAP_CELLS]', cc65Keys.cells)}
+
+${formatKeys(`const state_hash tile_keys[${HASH_TILES}]`, cc65Keys.tiles)}
+#else
+${formatKeys('const state_hash cell_keys[MAP_CELLS]', hostKeys.cells)}
+
+${formatKeys(`const state_hash tile_keys[${HASH_TILES}]`, hostKeys.tiles)}
+#endif
+#endif
+
+#endif // DUPLICATOR_TILE_PROPS_H
+`;
+
+const codes = `${banner('duplicator_tile_codes_16x16.h', 'Tile character to 16x16 screen code table')}
+
+// Include from exactly one source file (duplicator_tile_map_16x16.c)
+#ifndef DUPLICATOR_TILE_CODES_16X16_H
+#define DUPLICATOR_TILE_CODES_16X16_H
+
+// Base screen code (top-left corner) for every tile character; unknown
+// characters map to 0 like empty space
+${formatLegend(screen)}
+${formatTable('const byte tile_screen_codes_16x16', screen)}
+
+#endif // DUPLICATOR_TILE_CODES_16X16_H
+`;
+
+const outputs = [
+    ['duplicator_tile_props.h', props],
+    [path.join('duplicator8', 'duplicator_tile_props.h'), props],
+    ['duplicator_tile_codes_16x16.h', codes],
+];
+for (const [file, text] of outputs) {
+    fs.writeFileSync(path.join(rootDir, file), text);
+    console.log(`Wrote ${file}`);
+}